@@ -0,0 +1,55 @@
+#include "anim.h"
+
+int AnimationClipFrame(const AnimationClip *clip, float elapsed)
+{
+    if (elapsed < 0.0f) elapsed = 0.0f;
+    int frame = (int)(elapsed/clip->frameDuration);
+    if (clip->loop) return frame%clip->frameCount;
+    return (frame < clip->frameCount)? frame : -1;
+}
+
+void DrawAnimationFrame(const AnimationClip *clip, int frame, Vector2 position, float size, Color tint)
+{
+    Sprite sprite = clip->frames[frame];
+    DrawSpriteEx(sprite,
+        (Vector2){
+            position.x - (sprite.source.width*size)/2,
+            position.y - (sprite.source.height*size)/2
+        },
+        0.0f, size, tint);
+}
+
+bool AnimationStart(Animation *animations, int amount, const AnimationClip *clip, Vector2 position, Color tint, float size, float now)
+{
+    for (int i = 0; i < amount; i++) {
+        if (!animations[i].active) {
+            animations[i].clip = clip;
+            animations[i].position = position;
+            animations[i].startTime = now;
+            animations[i].tint = tint;
+            animations[i].size = size;
+            animations[i].active = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void UpdateDrawAnimations(Animation *animations, int amount, float now)
+{
+    for (int i = 0; i < amount; i++) {
+        if (!animations[i].active) continue;
+
+        int frame = AnimationClipFrame(animations[i].clip, now - animations[i].startTime);
+        if (frame < 0) {
+            animations[i].active = false;
+            continue;
+        }
+        DrawAnimationFrame(animations[i].clip, frame, animations[i].position, animations[i].size, animations[i].tint);
+    }
+}
+
+void AnimationClear(Animation *animations, int amount)
+{
+    for (int i = 0; i < amount; i++) animations[i].active = false;
+}
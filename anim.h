@@ -0,0 +1,38 @@
+#ifndef ANIM_H
+#define ANIM_H
+
+// Clips de animacion compartidos: los frames existen una sola vez (en el
+// atlas) y cada instancia solo guarda el clip, donde se dibuja y cuando
+// empezo. El frame se calcula a partir del tiempo transcurrido, asi que no
+// se acumula error aunque el framerate varie.
+#include "atlas.h"
+#include <stdbool.h>
+
+typedef struct AnimationClip {
+    const Sprite *frames;
+    int frameCount;
+    float frameDuration;    // Segundos por frame
+    bool loop;
+} AnimationClip;
+
+typedef struct Animation {
+    const AnimationClip *clip;
+    Vector2 position;
+    float startTime;
+    Color tint;
+    float size;
+    bool active;
+} Animation;
+
+// Frame que toca tras 'elapsed' segundos, o -1 si el clip ya termino
+int AnimationClipFrame(const AnimationClip *clip, float elapsed);
+// Dibuja un frame centrado en position
+void DrawAnimationFrame(const AnimationClip *clip, int frame, Vector2 position, float size, Color tint);
+
+// Usa la primera instancia libre; devuelve false si todas estan ocupadas
+bool AnimationStart(Animation *animations, int amount, const AnimationClip *clip, Vector2 position, Color tint, float size, float now);
+// Dibuja las instancias activas y libera las que terminaron
+void UpdateDrawAnimations(Animation *animations, int amount, float now);
+void AnimationClear(Animation *animations, int amount);
+
+#endif
@@ -0,0 +1,177 @@
+#include "archive.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI               // Choca con Rectangle de raylib
+    #define NOUSER              // Choca con CloseWindow/ShowCursor de raylib
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+static const unsigned char *mapping = NULL;
+static size_t mappingSize = 0;
+static const ArchiveEntry *entries = NULL;
+static unsigned int entryCount = 0;
+#if defined(_WIN32)
+    static HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    static HANDLE mappingHandle = NULL;
+#endif
+
+//----------------------------------------------------------------------------------
+// Mapeo
+//----------------------------------------------------------------------------------
+static bool MapFile(const char *fileName)
+{
+#if defined(_WIN32)
+    fileHandle = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fileHandle == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(fileHandle, &size) || size.QuadPart == 0) {
+        CloseHandle(fileHandle);
+        fileHandle = INVALID_HANDLE_VALUE;
+        return false;
+    }
+    mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mappingHandle != NULL) mapping = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (mapping == NULL) {
+        if (mappingHandle != NULL) CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        mappingHandle = NULL;
+        fileHandle = INVALID_HANDLE_VALUE;
+        return false;
+    }
+    mappingSize = (size_t)size.QuadPart;
+#else
+    int file = open(fileName, O_RDONLY);
+    if (file < 0) return false;
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0) {
+        close(file);
+        return false;
+    }
+    void *view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);    // El mapeo sigue valido sin el descriptor
+    if (view == MAP_FAILED) return false;
+    mapping = view;
+    mappingSize = (size_t)info.st_size;
+#endif
+    return true;
+}
+
+static void UnmapFile(void)
+{
+    if (mapping == NULL) return;
+#if defined(_WIN32)
+    UnmapViewOfFile(mapping);
+    CloseHandle(mappingHandle);
+    CloseHandle(fileHandle);
+    mappingHandle = NULL;
+    fileHandle = INVALID_HANDLE_VALUE;
+#else
+    munmap((void *)mapping, mappingSize);
+#endif
+    mapping = NULL;
+    mappingSize = 0;
+}
+
+// Todo lo que se va a leer cae dentro del archivo y cuadra con su formato
+static bool EntryValid(const ArchiveEntry *entry)
+{
+    if (memchr(entry->name, '\0', ARCHIVE_NAME_LENGTH) == NULL) return false;
+    if (entry->offset > mappingSize || entry->size > mappingSize - entry->offset) return false;
+    if (entry->kind == ARCHIVE_IMAGE) {
+        return entry->width > 0 && entry->height > 0 && entry->mipmaps == 1 &&
+               (unsigned int)GetPixelDataSize(entry->width, entry->height, entry->format) == entry->size;
+    }
+    if (entry->kind == ARCHIVE_WAVE) {
+        return entry->channels > 0 && (entry->sampleSize == 8 || entry->sampleSize == 16 || entry->sampleSize == 32) &&
+               (unsigned long long)entry->frameCount*entry->channels*(entry->sampleSize/8) == entry->size;
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------------------
+// API
+//----------------------------------------------------------------------------------
+bool ArchiveOpen(const char *fileName)
+{
+    ArchiveClose();
+    if (!MapFile(fileName)) return false;
+
+    const ArchiveHeader *header = (const ArchiveHeader *)mapping;
+    bool valid = mappingSize >= sizeof(ArchiveHeader) && memcmp(header->magic, "APAK", 4) == 0 &&
+                 header->version == ARCHIVE_VERSION && header->indexOffset % 4 == 0 &&
+                 header->indexOffset <= mappingSize &&
+                 (unsigned long long)header->entryCount*sizeof(ArchiveEntry) <= mappingSize - header->indexOffset;
+    if (valid) {
+        entries = (const ArchiveEntry *)(mapping + header->indexOffset);
+        entryCount = header->entryCount;
+        for (unsigned int i = 0; i < entryCount && valid; i++) {
+            valid = EntryValid(&entries[i]) && (i == 0 || strcmp(entries[i - 1].name, entries[i].name) < 0);
+        }
+    }
+    if (!valid) {
+        TraceLog(LOG_WARNING, "ARCHIVE: %s no es valido, se usan los archivos sueltos", fileName);
+        ArchiveClose();
+        return false;
+    }
+
+    TraceLog(LOG_INFO, "ARCHIVE: %s mapeado (%u recursos, %.1f MB)", fileName, entryCount, mappingSize/(1024.0*1024.0));
+    return true;
+}
+
+void ArchiveClose(void)
+{
+    UnmapFile();
+    entries = NULL;
+    entryCount = 0;
+}
+
+bool ArchiveIsOpen(void)
+{
+    return mapping != NULL;
+}
+
+static int CompareName(const void *name, const void *entry)
+{
+    return strcmp((const char *)name, ((const ArchiveEntry *)entry)->name);
+}
+
+static const ArchiveEntry *FindEntry(const char *name, ArchiveKind kind)
+{
+    if (entries == NULL) return NULL;
+    const ArchiveEntry *entry = bsearch(name, entries, entryCount, sizeof(ArchiveEntry), CompareName);
+    return (entry != NULL && entry->kind == (unsigned int)kind)? entry : NULL;
+}
+
+bool ArchiveImage(const char *name, Image *image)
+{
+    const ArchiveEntry *entry = FindEntry(name, ARCHIVE_IMAGE);
+    if (entry == NULL) return false;
+
+    image->data = (void *)(mapping + entry->offset);
+    image->width = entry->width;
+    image->height = entry->height;
+    image->format = entry->format;
+    image->mipmaps = entry->mipmaps;
+    return true;
+}
+
+bool ArchiveWave(const char *name, Wave *wave)
+{
+    const ArchiveEntry *entry = FindEntry(name, ARCHIVE_WAVE);
+    if (entry == NULL) return false;
+
+    wave->data = (void *)(mapping + entry->offset);
+    wave->frameCount = entry->frameCount;
+    wave->sampleRate = entry->sampleRate;
+    wave->sampleSize = entry->sampleSize;
+    wave->channels = entry->channels;
+    return true;
+}
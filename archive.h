@@ -0,0 +1,62 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+// Archivo de recursos (assets.pak): imagenes y sonidos ya decodificados, tal
+// y como se suben a la GPU o al dispositivo de audio, en un solo archivo que
+// se mapea en memoria. Cargar desde aqui no lee ni decodifica nada: los
+// datos de cada recurso son un puntero dentro del mapeo.
+//
+// Lo genera tools/packer.c (make pack). Si no existe el juego carga los
+// archivos sueltos de textures/ y sound/, asi que para desarrollar basta con
+// no generarlo (o borrarlo despues de cambiar una textura).
+//
+// Formato: cabecera, datos (cada uno alineado a ARCHIVE_ALIGNMENT) e indice
+// al final, ordenado por nombre. Los nombres son las rutas que usa el juego,
+// con '/' ("textures/lotus/1.png").
+#include "raylib.h"
+#include <stdbool.h>
+
+#define ARCHIVE_VERSION 1
+#define ARCHIVE_NAME_LENGTH 96
+#define ARCHIVE_ALIGNMENT 64
+
+typedef enum ArchiveKind {
+    ARCHIVE_IMAGE = 1,
+    ARCHIVE_WAVE = 2
+} ArchiveKind;
+
+typedef struct ArchiveHeader {
+    char magic[4];              // "APAK"
+    unsigned int version;
+    unsigned int entryCount;
+    unsigned int indexOffset;   // Desde el inicio del archivo
+} ArchiveHeader;
+
+// Una entrada del indice (144 bytes)
+typedef struct ArchiveEntry {
+    char name[ARCHIVE_NAME_LENGTH];
+    unsigned int kind;          // ArchiveKind
+    unsigned int offset;
+    unsigned int size;
+    int width;                  // ARCHIVE_IMAGE
+    int height;
+    int format;                 // PixelFormat
+    int mipmaps;
+    unsigned int frameCount;    // ARCHIVE_WAVE
+    unsigned int sampleRate;
+    unsigned int sampleSize;
+    unsigned int channels;
+    unsigned int padding;
+} ArchiveEntry;
+
+// false si no existe o no es valido: entonces se usan los archivos sueltos
+bool ArchiveOpen(const char *fileName);
+void ArchiveClose(void);
+bool ArchiveIsOpen(void);
+
+// Los datos apuntan al mapeo (solo lectura): no se liberan ni se modifican,
+// y dejan de ser validos con ArchiveClose()
+bool ArchiveImage(const char *name, Image *image);
+bool ArchiveWave(const char *name, Wave *wave);
+
+#endif
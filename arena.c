@@ -0,0 +1,66 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+struct ArenaBlock {
+    ArenaBlock *next;
+    unsigned char *data;    // Alineado a ARENA_ALIGNMENT
+    size_t size;
+    size_t offset;
+};
+
+static ArenaBlock *NewBlock(size_t size)
+{
+    ArenaBlock *block = malloc(sizeof(ArenaBlock) + size + ARENA_ALIGNMENT);
+    if (block == NULL) return NULL;
+
+    uintptr_t start = (uintptr_t)(block + 1);
+    start = (start + ARENA_ALIGNMENT - 1) & ~(uintptr_t)(ARENA_ALIGNMENT - 1);
+    block->next = NULL;
+    block->data = (unsigned char *)start;
+    block->size = size;
+    block->offset = 0;
+    return block;
+}
+
+void *ArenaAlloc(Arena *arena, size_t size)
+{
+    size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+
+    ArenaBlock *block = arena->blocks;
+    if (block == NULL || block->size - block->offset < size) {
+        block = NewBlock((size > ARENA_BLOCK_SIZE)? size : ARENA_BLOCK_SIZE);
+        if (block == NULL) return NULL;
+        block->next = arena->blocks;
+        arena->blocks = block;
+        arena->reserved += block->size;
+    }
+
+    void *result = block->data + block->offset;
+    block->offset += size;
+    arena->used += size;
+    return result;
+}
+
+void ArenaReset(Arena *arena)
+{
+    if (arena->blocks != NULL && arena->blocks->next != NULL) {
+        size_t total = arena->reserved;
+        ArenaFree(arena);
+        arena->blocks = NewBlock(total);
+        if (arena->blocks != NULL) arena->reserved = total;
+    }
+    if (arena->blocks != NULL) arena->blocks->offset = 0;
+    arena->used = 0;
+}
+
+void ArenaFree(Arena *arena)
+{
+    ArenaBlock *block = arena->blocks;
+    while (block != NULL) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    *arena = (Arena){ 0 };
+}
@@ -0,0 +1,29 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+// Arena lineal para la memoria que vive lo que dura una partida.
+// Pedir es avanzar un puntero; no hay liberacion individual: todo se suelta
+// de una vez con ArenaReset() al empezar la siguiente partida. Un arreglo
+// que crece pide uno nuevo y copia; el viejo queda ocupado hasta el reset
+// (creciendo al doble, como mucho otro tanto de lo que se usa).
+#include <stddef.h>
+
+#define ARENA_ALIGNMENT 64          // Linea de cache (y suficiente para AVX)
+#define ARENA_BLOCK_SIZE (1 << 20)  // Tamaño minimo de cada bloque
+
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct Arena {
+    ArenaBlock *blocks;     // El bloque actual primero
+    size_t used;            // Bytes pedidos desde el ultimo reset
+    size_t reserved;        // Bytes reservados en todos los bloques
+} Arena;
+
+// Memoria alineada a ARENA_ALIGNMENT y sin inicializar; NULL si no hay memoria
+void *ArenaAlloc(Arena *arena, size_t size);
+// Invalida todo lo pedido. Si la partida necesito varios bloques se
+// sustituyen por uno solo del tamaño total: la siguiente cabe entera en el
+void ArenaReset(Arena *arena);
+void ArenaFree(Arena *arena);
+
+#endif
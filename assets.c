@@ -0,0 +1,379 @@
+#include "assets.h"
+#include "loader.h"
+#include "archive.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef enum AssetKind {
+    ASSET_TEXTURE = 0,
+    ASSET_SPRITE,
+    ASSET_SOUND,
+    ASSET_MUSIC,
+    ASSET_KIND_COUNT
+} AssetKind;
+
+static const char *kindNames[ASSET_KIND_COUNT] = { "texture", "sprite", "sound", "music" };
+
+typedef struct AssetFile {
+    AssetKind kind;
+    char path[LOADER_PATH_LENGTH];
+    bool missing;       // No existe o no se pudo decodificar: sus slots usan la reserva
+    bool resident;      // Cargado y entregado
+    int refCount;
+    Texture2D texture;  // Destino del cargador, segun kind
+    Sprite sprite;
+    Sound sound;
+    Music music;
+} AssetFile;
+
+typedef struct AssetItem {
+    char name[ASSET_NAME_LENGTH];
+    AssetKind kind;
+    int first;          // Slots [first, first + count)
+    int count;
+    int refCount;
+} AssetItem;
+
+static AssetFile files[ASSET_MAX_FILES];
+static int fileCount = 0;
+static AssetItem items[ASSET_MAX_ITEMS];
+static int itemCount = 0;
+
+// Un slot por frame de cada entrada: asi los frames de una entrada quedan
+// contiguos aunque compartan archivos con otra
+static int slotFile[ASSET_MAX_SLOTS];
+static Texture2D textureSlots[ASSET_MAX_SLOTS];
+static Sprite spriteSlots[ASSET_MAX_SLOTS];
+static Sound soundSlots[ASSET_MAX_SLOTS];
+static Music musicSlots[ASSET_MAX_SLOTS];
+static int slotCount = 0;
+
+static Texture2D fallbackTexture = { 0 };
+static Sprite fallbackSprite = { 0 };
+static Sound fallbackSound = { 0 };     // Vacio: PlaySound no hace nada
+static Music fallbackMusic = { 0 };
+static bool loaded = false;
+
+#define ASSET_FALLBACK_SIZE 64
+
+static Image FallbackImage(void)
+{
+    return GenImageChecked(ASSET_FALLBACK_SIZE, ASSET_FALLBACK_SIZE, 8, 8, MAGENTA, BLACK);
+}
+
+//----------------------------------------------------------------------------------
+// Manifiesto
+//----------------------------------------------------------------------------------
+static int FindFile(AssetKind kind, const char *path)
+{
+    for (int i = 0; i < fileCount; i++) {
+        if (files[i].kind == kind && strcmp(files[i].path, path) == 0) return i;
+    }
+    if (fileCount >= ASSET_MAX_FILES) return -1;
+    AssetFile *file = &files[fileCount];
+    memset(file, 0, sizeof(*file));
+    file->kind = kind;
+    strcpy(file->path, path);
+    return fileCount++;
+}
+
+static int FindItem(const char *name)
+{
+    for (int i = 0; i < itemCount; i++) {
+        if (strcmp(items[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+// Con varios frames la ruta lleva un %d (y ningun otro %): es un formato de
+// printf que viene de un archivo, asi que no se acepta nada mas
+static bool ValidPattern(const char *path, int count)
+{
+    const char *mark = strchr(path, '%');
+    if (mark == NULL) return count == 1;
+    return mark[1] == 'd' && strchr(mark + 2, '%') == NULL;
+}
+
+// tipo nombre frames ruta (la ruta es el resto de la linea, puede llevar espacios)
+static void ParseLine(char *line, const char *fileName, int lineNumber)
+{
+    while (*line == ' ' || *line == '\t') line++;
+    if (*line == '\0' || *line == '#') return;
+
+    char kindText[16] = { 0 };
+    char name[ASSET_NAME_LENGTH] = { 0 };
+    int count = 0;
+    int pathStart = 0;
+    if (sscanf(line, "%15s %31s %d %n", kindText, name, &count, &pathStart) < 3 || pathStart == 0) {
+        TraceLog(LOG_WARNING, "ASSETS: %s:%d: linea no valida", fileName, lineNumber);
+        return;
+    }
+    const char *path = line + pathStart;
+
+    int kind = 0;
+    while (kind < ASSET_KIND_COUNT && strcmp(kindText, kindNames[kind]) != 0) kind++;
+    if (kind == ASSET_KIND_COUNT || count < 1 || path[0] == '\0' || !ValidPattern(path, count) ||
+        strlen(path) + 8 >= LOADER_PATH_LENGTH || (kind == ASSET_MUSIC && count != 1)) {
+        TraceLog(LOG_WARNING, "ASSETS: %s:%d: entrada no valida", fileName, lineNumber);
+        return;
+    }
+    if (FindItem(name) >= 0) {
+        TraceLog(LOG_WARNING, "ASSETS: %s:%d: %s repetido", fileName, lineNumber, name);
+        return;
+    }
+    if (itemCount >= ASSET_MAX_ITEMS || slotCount + count > ASSET_MAX_SLOTS) {
+        TraceLog(LOG_WARNING, "ASSETS: %s:%d: demasiados recursos", fileName, lineNumber);
+        return;
+    }
+
+    AssetItem *item = &items[itemCount];
+    memset(item, 0, sizeof(*item));
+    strcpy(item->name, name);
+    item->kind = (AssetKind)kind;
+    item->first = slotCount;
+    for (int frame = 1; frame <= count; frame++) {
+        char framePath[LOADER_PATH_LENGTH];
+        snprintf(framePath, sizeof(framePath), path, frame);
+        int file = FindFile(item->kind, framePath);
+        if (file < 0) {
+            TraceLog(LOG_WARNING, "ASSETS: Maximo de archivos alcanzado (%d)", ASSET_MAX_FILES);
+            break;
+        }
+        slotFile[slotCount++] = file;
+        item->count++;
+    }
+    if (item->count > 0) itemCount++;
+}
+
+static bool FileAvailable(const AssetFile *file)
+{
+    Image image;
+    Wave wave;
+    if (file->kind == ASSET_SOUND && ArchiveWave(file->path, &wave)) return true;
+    if ((file->kind == ASSET_TEXTURE || file->kind == ASSET_SPRITE) && ArchiveImage(file->path, &image)) return true;
+    return FileExists(file->path);
+}
+
+bool AssetsLoadManifest(const char *fileName)
+{
+    char *text = LoadFileText(fileName);
+    if (text == NULL) {
+        TraceLog(LOG_ERROR, "ASSETS: No se pudo leer el manifiesto %s", fileName);
+        return false;
+    }
+
+    int lineNumber = 0;
+    char *line = text;
+    while (line != NULL && *line != '\0') {
+        char *next = strchr(line, '\n');
+        if (next != NULL) *next++ = '\0';
+        size_t length = strlen(line);
+        if (length > 0 && line[length - 1] == '\r') line[length - 1] = '\0';
+        ParseLine(line, fileName, ++lineNumber);
+        line = next;
+    }
+    UnloadFileText(text);
+
+    // Todo lo que falta se avisa aqui, de una vez, y no se llega a pedir
+    int missing = 0;
+    for (int i = 0; i < fileCount; i++) {
+        files[i].missing = !FileAvailable(&files[i]);
+        if (files[i].missing) missing++;
+    }
+    if (missing > 0) {
+        TraceLog(LOG_WARNING, "ASSETS: Faltan %d de %d archivos (se usa la reserva):", missing, fileCount);
+        for (int i = 0; i < fileCount; i++) {
+            if (files[i].missing) TraceLog(LOG_WARNING, "ASSETS:     %s", files[i].path);
+        }
+    }
+
+    for (int i = 0; i < fileCount; i++) {
+        AssetFile *file = &files[i];
+        if (file->missing) continue;
+        if (file->kind == ASSET_TEXTURE) LoaderAddTexture(&file->texture, file->path);
+        else if (file->kind == ASSET_SPRITE) LoaderAddSprite(&file->sprite, file->path);
+        else if (file->kind == ASSET_SOUND) LoaderAddSound(&file->sound, file->path);
+    }
+    // La reserva de los sprites va al atlas con los demas
+    AtlasAddImage(&fallbackSprite, FallbackImage());
+
+    TraceLog(LOG_INFO, "ASSETS: %s: %d entradas, %d archivos", fileName, itemCount, fileCount);
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Carga y descarga
+//----------------------------------------------------------------------------------
+static void UpdateSlots(int file)
+{
+    const AssetFile *source = &files[file];
+    for (int slot = 0; slot < slotCount; slot++) {
+        if (slotFile[slot] != file) continue;
+        textureSlots[slot] = source->missing? fallbackTexture : source->texture;
+        spriteSlots[slot] = source->missing? fallbackSprite : source->sprite;
+        soundSlots[slot] = source->missing? fallbackSound : source->sound;
+        musicSlots[slot] = source->missing? fallbackMusic : source->music;
+    }
+}
+
+// Carga sincrona: la musica al pedirla, o lo que se libero y se vuelve a pedir
+static void LoadFileNow(AssetFile *file)
+{
+    if (file->kind == ASSET_TEXTURE) {
+        file->texture = LoadTexture(file->path);
+        file->missing = file->texture.id == 0;
+    } else if (file->kind == ASSET_SOUND) {
+        file->sound = LoadSound(file->path);
+        file->missing = file->sound.frameCount == 0;
+    } else if (file->kind == ASSET_MUSIC) {
+        file->music = LoadMusicStream(file->path);
+        file->missing = file->music.frameCount == 0;
+    }
+    file->resident = !file->missing;
+    if (file->missing) TraceLog(LOG_WARNING, "ASSETS: No se pudo cargar %s (se usa la reserva)", file->path);
+}
+
+static void UnloadFile(AssetFile *file)
+{
+    if (file->kind == ASSET_TEXTURE && file->texture.id != 0) UnloadTexture(file->texture);
+    if (file->kind == ASSET_SOUND && file->sound.frameCount != 0) UnloadSound(file->sound);
+    if (file->kind == ASSET_MUSIC && file->music.frameCount != 0) UnloadMusicStream(file->music);
+    file->texture = (Texture2D){ 0 };
+    file->sound = (Sound){ 0 };
+    file->music = (Music){ 0 };
+    file->resident = false;
+}
+
+void AssetsFinishLoad(void)
+{
+    if (loaded) return;
+
+    Image image = FallbackImage();
+    fallbackTexture = LoadTextureFromImage(image);
+    UnloadImage(image);
+
+    // Lo que el cargador no pudo decodificar tambien pasa a la reserva
+    for (int i = 0; i < fileCount; i++) {
+        AssetFile *file = &files[i];
+        if (file->missing || file->kind == ASSET_MUSIC) continue;
+        bool ok = (file->kind == ASSET_TEXTURE)? file->texture.id != 0 :
+                  (file->kind == ASSET_SPRITE)? file->sprite.texture.id != 0 : file->sound.frameCount != 0;
+        file->missing = !ok;
+        file->resident = ok;
+    }
+    loaded = true;
+    // Musica pedida antes de terminar la carga
+    for (int i = 0; i < fileCount; i++) {
+        if (files[i].kind == ASSET_MUSIC && files[i].refCount > 0 && !files[i].missing) LoadFileNow(&files[i]);
+    }
+    for (int i = 0; i < fileCount; i++) UpdateSlots(i);
+
+    AssetStats stats = AssetsGetStats();
+    TraceLog(LOG_INFO, "ASSETS: %d archivos (%d con reserva), %d texturas (%.1f MB), %d sonidos (%.1f MB)",
+             stats.files, stats.missing, stats.textures, stats.textureBytes/(1024.0*1024.0),
+             stats.sounds, stats.soundBytes/(1024.0*1024.0));
+}
+
+void AssetsUnloadAll(void)
+{
+    for (int i = 0; i < fileCount; i++) UnloadFile(&files[i]);
+    for (int i = 0; i < fileCount; i++) UpdateSlots(i);
+    if (fallbackTexture.id != 0) UnloadTexture(fallbackTexture);
+    fallbackTexture = (Texture2D){ 0 };
+    AtlasUnload();  // Sprites y su reserva
+    loaded = false;
+}
+
+//----------------------------------------------------------------------------------
+// Referencias
+//----------------------------------------------------------------------------------
+static const AssetItem *Acquire(const char *name, AssetKind kind)
+{
+    int index = FindItem(name);
+    if (index < 0 || items[index].kind != kind) {
+        TraceLog(LOG_WARNING, "ASSETS: %s %s no esta en el manifiesto", kindNames[kind], name);
+        return NULL;
+    }
+
+    AssetItem *item = &items[index];
+    item->refCount++;
+    for (int slot = item->first; slot < item->first + item->count; slot++) {
+        AssetFile *file = &files[slotFile[slot]];
+        // La musica se abre ahora; las texturas y sonidos liberados se recargan
+        bool reload = (kind == ASSET_MUSIC)? loaded : loaded && kind != ASSET_SPRITE && file->refCount == 0;
+        if (reload && !file->resident && !file->missing) {
+            LoadFileNow(file);
+            UpdateSlots(slotFile[slot]);
+        }
+        file->refCount++;
+    }
+    return item;
+}
+
+const Texture2D *AssetTextures(const char *name, int *count)
+{
+    const AssetItem *item = Acquire(name, ASSET_TEXTURE);
+    if (count != NULL) *count = (item != NULL)? item->count : 1;
+    return (item != NULL)? &textureSlots[item->first] : &fallbackTexture;
+}
+
+const Sprite *AssetSprites(const char *name, int *count)
+{
+    const AssetItem *item = Acquire(name, ASSET_SPRITE);
+    if (count != NULL) *count = (item != NULL)? item->count : 1;
+    return (item != NULL)? &spriteSlots[item->first] : &fallbackSprite;
+}
+
+const Sound *AssetSound(const char *name)
+{
+    const AssetItem *item = Acquire(name, ASSET_SOUND);
+    return (item != NULL)? &soundSlots[item->first] : &fallbackSound;
+}
+
+Music *AssetMusic(const char *name)
+{
+    const AssetItem *item = Acquire(name, ASSET_MUSIC);
+    return (item != NULL)? &musicSlots[item->first] : &fallbackMusic;
+}
+
+void AssetRelease(const char *name)
+{
+    int index = FindItem(name);
+    if (index < 0 || items[index].refCount <= 0) return;
+
+    AssetItem *item = &items[index];
+    item->refCount--;
+    for (int slot = item->first; slot < item->first + item->count; slot++) {
+        AssetFile *file = &files[slotFile[slot]];
+        if (--file->refCount > 0 || file->kind == ASSET_SPRITE) continue;
+        UnloadFile(file);
+        UpdateSlots(slotFile[slot]);
+    }
+}
+
+AssetStats AssetsGetStats(void)
+{
+    AssetStats stats = { 0 };
+    stats.files = fileCount;
+    stats.textures = AtlasTextureCount();
+    stats.textureBytes = AtlasTextureBytes();
+    if (fallbackTexture.id != 0) {
+        stats.textures++;
+        stats.textureBytes += GetPixelDataSize(fallbackTexture.width, fallbackTexture.height, fallbackTexture.format);
+    }
+
+    for (int i = 0; i < fileCount; i++) {
+        const AssetFile *file = &files[i];
+        if (file->missing) stats.missing++;
+        if (!file->resident) continue;
+        if (file->kind == ASSET_TEXTURE) {
+            stats.textures++;
+            stats.textureBytes += GetPixelDataSize(file->texture.width, file->texture.height, file->texture.format);
+        } else if (file->kind == ASSET_SOUND) {
+            // La musica no cuenta: se lee por trozos
+            stats.sounds++;
+            stats.soundBytes += (long long)file->sound.frameCount*file->sound.stream.channels*(file->sound.stream.sampleSize/8);
+        }
+    }
+    return stats;
+}
@@ -0,0 +1,63 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+// Registro de recursos: que se carga y de donde sale de un manifiesto
+// (assets.txt), no de rutas repartidas por el codigo.
+//
+//   AssetsLoadManifest("assets.txt");       // Antes de LoaderStart()
+//   ...
+//   if (LoaderUpdate(...)) AssetsFinishLoad();
+//   const Sprite *frames = AssetSprites("lotus", &count);
+//   ...
+//   AssetsUnloadAll();                      // Antes de CloseWindow()
+//
+// Cada archivo se pide al cargador una sola vez aunque lo usen varias
+// entradas. Al leer el manifiesto se comprueba que existen todos (en
+// assets.pak o sueltos) y se avisa de los que faltan de una vez; esos, y
+// los que no se pueden decodificar, quedan apuntando a un unico recurso de
+// reserva compartido (un damero magenta) en lugar de crear uno por hueco.
+//
+// Los punteros que devuelven Asset*() son estables desde que se lee el
+// manifiesto, pero su contenido no es valido hasta AssetsFinishLoad(). Cada
+// llamada suma una referencia; AssetRelease() la quita y, al llegar a 0,
+// libera las texturas y sonidos que ya no usa nadie (los sprites viven en
+// el atlas hasta AssetsUnloadAll()).
+#include "raylib.h"
+#include "atlas.h"
+#include <stdbool.h>
+
+#define ASSET_MAX_ITEMS 64      // Entradas del manifiesto
+#define ASSET_MAX_FILES 128     // Archivos distintos
+#define ASSET_MAX_SLOTS 256     // Frames de todas las entradas
+#define ASSET_NAME_LENGTH 32
+
+// Lo que hay cargado ahora mismo (texturas y bytes cuentan el atlas y la reserva)
+typedef struct AssetStats {
+    int files;
+    int missing;                // Archivos que faltan o no se pudieron decodificar
+    int textures;               // Texturas en la GPU
+    long long textureBytes;
+    int sounds;
+    long long soundBytes;
+} AssetStats;
+
+// Lee el manifiesto y pide al cargador todos los archivos que existen;
+// false si no se pudo leer
+bool AssetsLoadManifest(const char *fileName);
+// Con LoaderUpdate() ya terminado: rellena las entradas y pone la reserva
+// donde falta algo
+void AssetsFinishLoad(void);
+void AssetsUnloadAll(void);
+
+// count recibe el numero de frames; un nombre que no esta en el manifiesto
+// (o es de otro tipo) devuelve la reserva con count = 1
+const Texture2D *AssetTextures(const char *name, int *count);
+const Sprite *AssetSprites(const char *name, int *count);
+const Sound *AssetSound(const char *name);
+// La musica se abre al pedirla por primera vez (necesita el audio iniciado)
+Music *AssetMusic(const char *name);
+void AssetRelease(const char *name);
+
+AssetStats AssetsGetStats(void);
+
+#endif
@@ -0,0 +1,257 @@
+#include "atlas.h"
+#include "rlgl.h"
+#include <stddef.h>
+
+typedef struct AtlasEntry {
+    Sprite *sprite;     // Donde se escribe el resultado en AtlasBuild
+    Image image;
+} AtlasEntry;
+
+static AtlasEntry entries[ATLAS_MAX_SPRITES];
+static int entryCount = 0;
+static Texture2D pages[ATLAS_MAX_PAGES];
+static int pageCount = 0;
+
+// Lo que no cabe en una pagina se sube como textura suelta
+static Texture2D loose[ATLAS_MAX_SPRITES];
+static int looseCount = 0;
+
+// Bloque blanco para las figuras (DrawCircle, DrawRectangle...): con
+// SetShapesTexture apuntando aqui comparten batch con los sprites
+#define ATLAS_WHITE_SIZE 4
+
+//----------------------------------------------------------------------------------
+// Construccion
+//----------------------------------------------------------------------------------
+bool AtlasAdd(Sprite *sprite, const char *fileName)
+{
+    Image image = LoadImage(fileName);
+    if (image.data == NULL) {
+        TraceLog(LOG_WARNING, "ATLAS: No se pudo cargar %s", fileName);
+        *sprite = (Sprite){ 0 };
+        return false;
+    }
+    AtlasAddImage(sprite, image);
+    return true;
+}
+
+void AtlasAddImage(Sprite *sprite, Image image)
+{
+    *sprite = (Sprite){ 0 };
+    if (entryCount >= ATLAS_MAX_SPRITES) {
+        TraceLog(LOG_WARNING, "ATLAS: Maximo de sprites alcanzado (%d)", ATLAS_MAX_SPRITES);
+        UnloadImage(image);
+        return;
+    }
+    entries[entryCount].sprite = sprite;
+    entries[entryCount].image = image;
+    entryCount++;
+}
+
+static void AtlasAddLoose(AtlasEntry *entry)
+{
+    Texture2D texture = LoadTextureFromImage(entry->image);
+    if (looseCount < ATLAS_MAX_SPRITES) loose[looseCount++] = texture;
+    entry->sprite->texture = texture;
+    entry->sprite->source = (Rectangle){ 0, 0, (float)texture.width, (float)texture.height };
+}
+
+int AtlasBuild(void)
+{
+    static int order[ATLAS_MAX_SPRITES];
+    static Image pageImages[ATLAS_MAX_PAGES];
+    static int entryPage[ATLAS_MAX_SPRITES];
+    static Rectangle entryRect[ATLAS_MAX_SPRITES];
+
+    // Mas altos primero: las estanterias quedan mas llenas
+    for (int i = 0; i < entryCount; i++) {
+        int j = i;
+        while (j > 0 && entries[order[j - 1]].image.height < entries[i].image.height) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    // Empaquetado por estanterias; la pagina 0 empieza con el bloque blanco
+    int looseBefore = looseCount;
+    int page = 0;
+    int x = ATLAS_PADDING*2 + ATLAS_WHITE_SIZE;
+    int y = ATLAS_PADDING;
+    int shelfHeight = ATLAS_WHITE_SIZE;
+    pageImages[0] = GenImageColor(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, BLANK);
+    ImageDrawRectangle(&pageImages[0], ATLAS_PADDING, ATLAS_PADDING, ATLAS_WHITE_SIZE, ATLAS_WHITE_SIZE, WHITE);
+    pageCount = 1;
+
+    for (int n = 0; n < entryCount; n++) {
+        int i = order[n];
+        int w = entries[i].image.width;
+        int h = entries[i].image.height;
+        entryPage[i] = -1;
+
+        if (w + 2*ATLAS_PADDING > ATLAS_PAGE_SIZE || h + 2*ATLAS_PADDING > ATLAS_PAGE_SIZE) continue;
+
+        if (x + w + ATLAS_PADDING > ATLAS_PAGE_SIZE) {
+            x = ATLAS_PADDING;
+            y += shelfHeight + ATLAS_PADDING;
+            shelfHeight = 0;
+        }
+        if (y + h + ATLAS_PADDING > ATLAS_PAGE_SIZE) {
+            if (pageCount >= ATLAS_MAX_PAGES) continue;
+            page = pageCount++;
+            pageImages[page] = GenImageColor(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, BLANK);
+            x = ATLAS_PADDING;
+            y = ATLAS_PADDING;
+            shelfHeight = 0;
+        }
+
+        entryPage[i] = page;
+        entryRect[i] = (Rectangle){ (float)x, (float)y, (float)w, (float)h };
+        ImageDraw(&pageImages[page], entries[i].image, (Rectangle){ 0, 0, (float)w, (float)h }, entryRect[i], WHITE);
+        x += w + ATLAS_PADDING;
+        if (h > shelfHeight) shelfHeight = h;
+    }
+
+    for (int p = 0; p < pageCount; p++) {
+        pages[p] = LoadTextureFromImage(pageImages[p]);
+        UnloadImage(pageImages[p]);
+    }
+
+    for (int i = 0; i < entryCount; i++) {
+        if (entryPage[i] >= 0) {
+            entries[i].sprite->texture = pages[entryPage[i]];
+            entries[i].sprite->source = entryRect[i];
+        } else {
+            AtlasAddLoose(&entries[i]);
+        }
+        UnloadImage(entries[i].image);
+    }
+
+    SetShapesTexture(pages[0], (Rectangle){ ATLAS_PADDING + 1, ATLAS_PADDING + 1, ATLAS_WHITE_SIZE - 2, ATLAS_WHITE_SIZE - 2 });
+
+    TraceLog(LOG_INFO, "ATLAS: %d sprites, %d paginas de %dx%d (%d sueltos)",
+             entryCount, pageCount, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, looseCount - looseBefore);
+    entryCount = 0;
+    return pageCount;
+}
+
+void AtlasUnload(void)
+{
+    // Las figuras vuelven a la textura por defecto de raylib
+    SetShapesTexture((Texture2D){ 0 }, (Rectangle){ 0 });
+    for (int p = 0; p < pageCount; p++) UnloadTexture(pages[p]);
+    for (int i = 0; i < looseCount; i++) UnloadTexture(loose[i]);
+    pageCount = 0;
+    looseCount = 0;
+}
+
+int AtlasTextureCount(void)
+{
+    return pageCount + looseCount;
+}
+
+long long AtlasTextureBytes(void)
+{
+    long long bytes = 0;
+    for (int p = 0; p < pageCount; p++) bytes += GetPixelDataSize(pages[p].width, pages[p].height, pages[p].format);
+    for (int i = 0; i < looseCount; i++) bytes += GetPixelDataSize(loose[i].width, loose[i].height, loose[i].format);
+    return bytes;
+}
+
+//----------------------------------------------------------------------------------
+// Dibujo
+//----------------------------------------------------------------------------------
+static void DrawStatsReserve(int vertices);
+
+void DrawSprite(Sprite sprite, float x, float y, Color tint)
+{
+    DrawStatsReserve(4);
+    DrawTextureRec(sprite.texture, sprite.source, (Vector2){ x, y }, tint);
+}
+
+void DrawSpriteEx(Sprite sprite, Vector2 position, float rotation, float scale, Color tint)
+{
+    Rectangle dest = { position.x, position.y, sprite.source.width*scale, sprite.source.height*scale };
+    DrawStatsReserve(4);
+    DrawTexturePro(sprite.texture, sprite.source, dest, (Vector2){ 0, 0 }, rotation, tint);
+}
+
+void DrawSpritePro(Sprite sprite, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint)
+{
+    source.x += sprite.source.x;
+    source.y += sprite.source.y;
+    DrawStatsReserve(4);
+    DrawTexturePro(sprite.texture, source, dest, origin, rotation, tint);
+}
+
+//----------------------------------------------------------------------------------
+// Estadisticas de dibujo
+//----------------------------------------------------------------------------------
+// raylib no expone el batch por defecto, asi que usamos uno propio y contamos
+// sus entradas antes de cada vaciado. Si rlgl lo vacia por su cuenta (vertices
+// o llamadas agotados) esas entradas se pierden para las estadisticas: el batch
+// es lo bastante grande para el HUD y los overlays de un frame, y los sprites,
+// que son lo que crece con la horda, lo vacian antes con DrawStatsReserve()
+#define STATS_BATCH_QUADS 16384 // Lo maximo que direccionan los indices de 16 bits en GLES2
+static rlRenderBatch statsBatch = { 0 };
+static bool statsReady = false;
+static DrawStats statsFrame = { 0 };
+static unsigned int statsLastTexture = 0;
+
+void DrawStatsInit(void)
+{
+    statsBatch = rlLoadRenderBatch(RL_DEFAULT_BATCH_BUFFERS, STATS_BATCH_QUADS);
+    rlSetRenderBatchActive(&statsBatch);
+    statsReady = true;
+}
+
+void DrawStatsFlush(void)
+{
+    if (!statsReady) return;
+
+    for (int i = 0; i < statsBatch.drawCounter; i++) {
+        rlDrawCall *draw = &statsBatch.draws[i];
+        if (draw->vertexCount <= 0) continue;
+        statsFrame.drawCalls++;
+        statsFrame.vertices += draw->vertexCount;
+        if (draw->textureId != statsLastTexture) {
+            statsFrame.textureSwitches++;
+            statsLastTexture = draw->textureId;
+        }
+    }
+    rlDrawRenderBatchActive();
+}
+
+// Vacia el batch (contandolo) si el siguiente dibujo haria que rlgl lo vaciase
+// por su cuenta: misma cantidad de vaciados, pero ninguno se escapa al recuento
+static void DrawStatsReserve(int vertices)
+{
+    if (!statsReady) return;
+
+    // Un cambio de textura abre una llamada nueva; rlgl vacia al llegar al tope
+    if (statsBatch.drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS - 1) {
+        DrawStatsFlush();
+        return;
+    }
+    int used = 0;
+    for (int i = 0; i < statsBatch.drawCounter; i++) {
+        used += statsBatch.draws[i].vertexCount + statsBatch.draws[i].vertexAlignment;
+    }
+    if (used + vertices >= statsBatch.vertexBuffer[statsBatch.currentBuffer].elementCount*4) DrawStatsFlush();
+}
+
+DrawStats DrawStatsEndFrame(void)
+{
+    DrawStats stats = statsFrame;
+    statsFrame = (DrawStats){ 0 };
+    statsLastTexture = 0;
+    return stats;
+}
+
+void DrawStatsUnload(void)
+{
+    if (!statsReady) return;
+    rlSetRenderBatchActive(NULL);
+    rlUnloadRenderBatch(statsBatch);
+    statsReady = false;
+}
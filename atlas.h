@@ -0,0 +1,53 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+
+// Atlas de texturas: los sprites pequeños se empaquetan en una o pocas paginas
+// para que raylib pueda dibujar toda la horda sin cambiar de textura (cada
+// cambio corta el batch y cuesta una llamada de dibujo).
+//
+// Uso: AtlasAdd() registra cada archivo con el Sprite donde debe quedar,
+// AtlasBuild() empaqueta, sube las paginas y rellena los Sprite registrados.
+// Los Sprite no son validos hasta despues de AtlasBuild(), que se llama una
+// sola vez con la ventana ya creada.
+#include "raylib.h"
+#include <stdbool.h>
+
+#define ATLAS_PAGE_SIZE 1024
+#define ATLAS_MAX_PAGES 4
+#define ATLAS_MAX_SPRITES 256
+#define ATLAS_PADDING 2
+
+typedef struct Sprite {
+    Texture2D texture;  // Pagina del atlas (id 0 si no se pudo cargar)
+    Rectangle source;   // Subrectangulo dentro de la pagina
+} Sprite;
+
+// Llamadas de dibujo del ultimo frame, contadas en el batch de rlgl
+typedef struct DrawStats {
+    int drawCalls;
+    int textureSwitches;
+    int vertices;
+} DrawStats;
+
+bool AtlasAdd(Sprite *sprite, const char *fileName);
+void AtlasAddImage(Sprite *sprite, Image image); // El atlas se queda con la imagen
+int AtlasBuild(void);   // Devuelve el numero de paginas
+void AtlasUnload(void);
+// Texturas en la GPU (paginas y sprites sueltos) y lo que ocupan
+int AtlasTextureCount(void);
+long long AtlasTextureBytes(void);
+
+void DrawSprite(Sprite sprite, float x, float y, Color tint);
+void DrawSpriteEx(Sprite sprite, Vector2 position, float rotation, float scale, Color tint);
+// source es relativo al sprite, como si fuera una textura suelta
+void DrawSpritePro(Sprite sprite, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint);
+
+// Estadisticas: DrawStatsInit() necesita el contexto GL ya creado.
+// DrawStatsFlush() va justo antes de EndMode2D()/EndDrawing() y
+// DrawStatsEndFrame() despues de EndDrawing().
+void DrawStatsInit(void);
+void DrawStatsFlush(void);
+DrawStats DrawStatsEndFrame(void);
+void DrawStatsUnload(void);
+
+#endif
@@ -0,0 +1,351 @@
+#include "audio.h"
+#include "raymath.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI               // Choca con Rectangle de raylib
+    #define NOUSER              // Choca con CloseWindow/ShowCursor de raylib
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <time.h>
+#endif
+
+typedef enum AudioCommandType {
+    AUDIO_PLAY = 0,
+    AUDIO_STOP,
+    AUDIO_PAUSE,
+    AUDIO_RESUME,
+    AUDIO_VOLUME
+} AudioCommandType;
+
+typedef struct AudioCommand {
+    AudioCommandType type;
+    Music music;
+    float volume;
+} AudioCommand;
+
+// Cola de un productor (el juego) y un consumidor (el hilo de audio): head
+// solo lo escribe el hilo de audio y tail solo el juego
+static AudioCommand queue[AUDIO_QUEUE_SIZE];
+static unsigned int queueHead = 0;
+static unsigned int queueTail = 0;
+static int dropped = 0;
+
+// Estado del hilo de audio
+static Music music = { 0 };
+static bool playing = false;        // Ni parada ni en pausa
+static unsigned long long lastUpdate = 0;
+static int underruns = 0;           // Atomico
+static int running = 0;
+static bool threaded = false;
+
+#if defined(_WIN32)
+    static HANDLE thread;
+#else
+    static pthread_t thread;
+#endif
+
+// Grupos de voces (solo el hilo del juego)
+typedef struct AudioVoicePool {
+    Sound voices[AUDIO_VOICES];     // La 0 es el Sound original, el resto alias
+    unsigned int started[AUDIO_VOICES]; // Orden de lanzamiento, para reutilizar la mas antigua
+    int voiceCount;
+} AudioVoicePool;
+
+// Lo pedido de un sonido en el frame actual
+typedef struct AudioSoundRequest {
+    int pool;
+    int count;
+    Vector2 position;               // La mas cercana de las pedidas
+    float volume;
+} AudioSoundRequest;
+
+static AudioVoicePool pools[AUDIO_MAX_POOLS];
+static int poolCount = 0;
+static AudioSoundRequest requests[AUDIO_MAX_POOLS];
+static int requestCount = 0;
+static Vector2 listener = { 0 };    // La del frame anterior, para elegir la mas cercana
+static unsigned int startSerial = 0;
+static AudioVoiceStats voiceStats = { 0 };
+
+static unsigned long long AudioNow(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (unsigned long long)((double)counter.QuadPart*1e9/(double)frequency.QuadPart);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec*1000000000ull + (unsigned long long)now.tv_nsec;
+#endif
+}
+
+static void AudioSleep(int milliseconds)
+{
+#if defined(_WIN32)
+    Sleep(milliseconds);
+#else
+    struct timespec wait = { 0, milliseconds*1000000L };
+    nanosleep(&wait, NULL);
+#endif
+}
+
+//----------------------------------------------------------------------------------
+// Hilo de audio
+//----------------------------------------------------------------------------------
+static void RunCommand(const AudioCommand *command)
+{
+    switch (command->type) {
+        case AUDIO_PLAY:
+            if (music.frameCount != 0) StopMusicStream(music);
+            music = command->music;
+            PlayMusicStream(music);
+            playing = true;
+            lastUpdate = AudioNow();
+            break;
+        case AUDIO_STOP:
+            if (music.frameCount != 0) StopMusicStream(music);
+            music = (Music){ 0 };
+            playing = false;
+            break;
+        case AUDIO_PAUSE:
+            if (music.frameCount != 0) PauseMusicStream(music);
+            playing = false;
+            break;
+        case AUDIO_RESUME:
+            if (music.frameCount != 0) ResumeMusicStream(music);
+            playing = (music.frameCount != 0);
+            lastUpdate = AudioNow();
+            break;
+        case AUDIO_VOLUME:
+            if (music.frameCount != 0) SetMusicVolume(music, command->volume);
+            break;
+    }
+}
+
+// Ordenes pendientes y relleno de los buffers que ya se han reproducido
+static void AudioTick(void)
+{
+    unsigned int head = __atomic_load_n(&queueHead, __ATOMIC_RELAXED);
+    while (head != __atomic_load_n(&queueTail, __ATOMIC_ACQUIRE)) {
+        AudioCommand command = queue[head%AUDIO_QUEUE_SIZE];
+        __atomic_store_n(&queueHead, head + 1, __ATOMIC_RELEASE);
+        RunCommand(&command);
+        head++;
+    }
+    if (!playing) return;
+
+    // Mas tiempo sin rellenar del que suenan los dos buffers: ha habido silencio
+    unsigned long long now = AudioNow();
+    unsigned int sampleRate = (music.stream.sampleRate != 0)? music.stream.sampleRate : 44100;
+    unsigned long long buffered = 2ull*AUDIO_STREAM_FRAMES*1000000000ull/sampleRate;
+    if (now - lastUpdate > buffered) __atomic_fetch_add(&underruns, 1, __ATOMIC_RELAXED);
+    lastUpdate = now;
+
+    UpdateMusicStream(music);
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI AudioMain(LPVOID arg)
+#else
+static void *AudioMain(void *arg)
+#endif
+{
+    (void)arg;
+    while (__atomic_load_n(&running, __ATOMIC_ACQUIRE)) {
+        AudioTick();
+        AudioSleep(AUDIO_UPDATE_MS);
+    }
+    AudioTick();    // Las ultimas ordenes (normalmente parar)
+#if defined(_WIN32)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+static void Enqueue(const AudioCommand *command)
+{
+    // Sin hilo no hay nadie mas tocando la musica: directamente
+    if (!threaded) {
+        RunCommand(command);
+        return;
+    }
+    unsigned int tail = __atomic_load_n(&queueTail, __ATOMIC_RELAXED);
+    if (tail - __atomic_load_n(&queueHead, __ATOMIC_ACQUIRE) >= AUDIO_QUEUE_SIZE) {
+        dropped++;
+        TraceLog(LOG_WARNING, "AUDIO: Cola llena, %d ordenes perdidas", dropped);
+        return;
+    }
+    queue[tail%AUDIO_QUEUE_SIZE] = *command;
+    __atomic_store_n(&queueTail, tail + 1, __ATOMIC_RELEASE);
+}
+
+//----------------------------------------------------------------------------------
+// API (hilo del juego)
+//----------------------------------------------------------------------------------
+void AudioStart(void)
+{
+    // Los streams que se abran a partir de aqui usan buffers de este tamano
+    SetAudioStreamBufferSizeDefault(AUDIO_STREAM_FRAMES);
+
+    running = 1;
+#if defined(_WIN32)
+    thread = CreateThread(NULL, 0, AudioMain, NULL, 0, NULL);
+    threaded = (thread != NULL);
+#else
+    threaded = (pthread_create(&thread, NULL, AudioMain, NULL) == 0);
+#endif
+    if (!threaded) TraceLog(LOG_WARNING, "AUDIO: No se pudo crear el hilo de musica");
+    else TraceLog(LOG_INFO, "AUDIO: Hilo de musica (cada %d ms, buffers de %d frames)", AUDIO_UPDATE_MS, AUDIO_STREAM_FRAMES);
+}
+
+void AudioShutdown(void)
+{
+    for (int p = 0; p < poolCount; p++) {
+        for (int v = 1; v < pools[p].voiceCount; v++) UnloadSoundAlias(pools[p].voices[v]);
+    }
+    poolCount = 0;
+    requestCount = 0;
+    voiceStats = (AudioVoiceStats){ 0 };
+
+    AudioStopMusic();
+    if (!threaded) return;
+    __atomic_store_n(&running, 0, __ATOMIC_RELEASE);
+#if defined(_WIN32)
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+    threaded = false;
+}
+
+void AudioPlayMusic(Music newMusic)
+{
+    AudioCommand command = { .type = AUDIO_PLAY, .music = newMusic };
+    Enqueue(&command);
+}
+
+void AudioStopMusic(void)
+{
+    AudioCommand command = { .type = AUDIO_STOP };
+    Enqueue(&command);
+}
+
+void AudioPauseMusic(void)
+{
+    AudioCommand command = { .type = AUDIO_PAUSE };
+    Enqueue(&command);
+}
+
+void AudioResumeMusic(void)
+{
+    AudioCommand command = { .type = AUDIO_RESUME };
+    Enqueue(&command);
+}
+
+void AudioSetMusicVolume(float volume)
+{
+    AudioCommand command = { .type = AUDIO_VOLUME, .volume = volume };
+    Enqueue(&command);
+}
+
+int AudioUnderruns(void)
+{
+    return __atomic_load_n(&underruns, __ATOMIC_RELAXED);
+}
+
+//----------------------------------------------------------------------------------
+// Efectos (hilo del juego)
+//----------------------------------------------------------------------------------
+int AudioSoundPool(Sound sound)
+{
+    if (poolCount >= AUDIO_MAX_POOLS) {
+        TraceLog(LOG_WARNING, "AUDIO: No caben mas grupos de voces");
+        return -1;
+    }
+    AudioVoicePool *pool = &pools[poolCount];
+    memset(pool, 0, sizeof(*pool));
+    pool->voices[0] = sound;
+    pool->voiceCount = 1;
+    // Sin muestras (recurso de reserva) no tiene sentido crear alias
+    if (sound.frameCount != 0) {
+        for (int v = 1; v < AUDIO_VOICES; v++) pool->voices[pool->voiceCount++] = LoadSoundAlias(sound);
+    }
+    voiceStats.voices += pool->voiceCount;
+    return poolCount++;
+}
+
+void AudioPlaySound(int pool, Vector2 position)
+{
+    if (pool < 0 || pool >= poolCount) return;
+    for (int r = 0; r < requestCount; r++) {
+        if (requests[r].pool != pool) continue;
+        requests[r].count++;
+        if (Vector2DistanceSqr(position, listener) < Vector2DistanceSqr(requests[r].position, listener)) {
+            requests[r].position = position;
+        }
+        return;
+    }
+    requests[requestCount++] = (AudioSoundRequest){ pool, 1, position, 0.0f };
+}
+
+static int CompareRequests(const void *a, const void *b)
+{
+    float va = ((const AudioSoundRequest *)a)->volume;
+    float vb = ((const AudioSoundRequest *)b)->volume;
+    return (va < vb) - (va > vb);
+}
+
+void AudioFlushSounds(Vector2 position)
+{
+    listener = position;
+    voiceStats.played = 0;
+    voiceStats.coalesced = 0;
+    voiceStats.culled = 0;
+
+    // Prioridad = volumen: cae con la distancia y sube un poco si se junto con otras
+    for (int r = 0; r < requestCount; r++) {
+        float distance = Vector2Distance(requests[r].position, listener);
+        float volume = 1.0f/(1.0f + distance/AUDIO_FALLOFF);
+        if (requests[r].count > 1) volume *= 1.25f;
+        requests[r].volume = (volume > 1.0f)? 1.0f : volume;
+        voiceStats.coalesced += requests[r].count - 1;
+    }
+    qsort(requests, requestCount, sizeof(AudioSoundRequest), CompareRequests);
+
+    for (int r = 0; r < requestCount; r++) {
+        if (r >= AUDIO_SOUNDS_PER_FRAME || requests[r].volume < AUDIO_MIN_VOLUME) {
+            voiceStats.culled += requests[r].count;
+            continue;
+        }
+        AudioVoicePool *pool = &pools[requests[r].pool];
+        int voice = 0;
+        for (int v = 0; v < pool->voiceCount; v++) {
+            if (!IsSoundPlaying(pool->voices[v])) { voice = v; break; }
+            if (pool->started[v] < pool->started[voice]) voice = v;
+        }
+        SetSoundVolume(pool->voices[voice], requests[r].volume);
+        PlaySound(pool->voices[voice]);
+        pool->started[voice] = ++startSerial;
+        voiceStats.played++;
+    }
+    requestCount = 0;
+}
+
+AudioVoiceStats AudioGetVoiceStats(void)
+{
+    AudioVoiceStats stats = voiceStats;
+    stats.active = 0;
+    for (int p = 0; p < poolCount; p++) {
+        for (int v = 0; v < pools[p].voiceCount; v++) stats.active += IsSoundPlaying(pools[p].voices[v]);
+    }
+    return stats;
+}
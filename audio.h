@@ -0,0 +1,76 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+// Musica en su propio hilo: lee y decodifica el stream y rellena los buffers
+// cada pocos milisegundos, asi que un frame largo (una carga, un pico de
+// colisiones, el paron tras resucitar) no deja la musica sin datos.
+//
+//   InitAudioDevice();
+//   AudioStart();                   // Antes de abrir la musica
+//   AudioPlayMusic(*AssetMusic("music"));
+//   ...
+//   AudioShutdown();                // Antes de liberar la musica
+//
+// El juego no toca el Music: le manda ordenes (tocar, pausar, volumen) por
+// una cola sin bloqueos de un productor y un consumidor, y solo las puede
+// mandar un hilo.
+//
+// Los efectos van por grupos de voces (alias del mismo Sound, que comparten
+// las muestras): un disparo no corta al anterior. Las peticiones de un frame
+// se juntan y se lanzan todas en AudioFlushSounds():
+//
+//   int shoot = AudioSoundPool(*AssetSound("shoot"));
+//   AudioPlaySound(shoot, position);    // Las veces que haga falta
+//   AudioFlushSounds(sim.player.position);  // Una vez por frame
+//
+// Varias peticiones del mismo sonido en un frame suenan una sola vez (desde
+// la mas cercana, algo mas fuerte); el volumen baja con la distancia al
+// jugador y, si hay mas sonidos distintos que AUDIO_SOUNDS_PER_FRAME, se
+// quedan fuera los mas lejanos. Sin voces libres se reutiliza la mas
+// antigua, asi que el mezclador nunca tiene mas de AUDIO_VOICES por sonido.
+#include "raylib.h"
+#include <stdbool.h>
+
+#define AUDIO_QUEUE_SIZE 32
+#define AUDIO_STREAM_FRAMES 4096    // Frames por buffer del stream (hay dos)
+#define AUDIO_UPDATE_MS 5           // Cada cuanto despierta el hilo
+
+#define AUDIO_MAX_POOLS 8           // Sonidos con grupo de voces
+#define AUDIO_VOICES 8              // Voces (alias) por sonido
+#define AUDIO_SOUNDS_PER_FRAME 4    // Sonidos distintos que se lanzan por frame
+#define AUDIO_FALLOFF 600.0f        // A esta distancia un sonido suena a la mitad
+#define AUDIO_MIN_VOLUME 0.05f      // Por debajo no se lanza
+
+// Efectos del ultimo frame, para el modo debug
+typedef struct AudioVoiceStats {
+    int voices;                     // Voces de todos los grupos
+    int active;                     // Sonando ahora
+    int played;                     // Lanzados en el ultimo frame
+    int coalesced;                  // Peticiones juntadas con otra igual
+    int culled;                     // Descartadas (tope por frame o muy lejos)
+} AudioVoiceStats;
+
+void AudioStart(void);
+// Tambien libera los alias de los grupos de voces
+void AudioShutdown(void);
+
+// Sustituye la que sonara antes
+void AudioPlayMusic(Music music);
+void AudioStopMusic(void);
+void AudioPauseMusic(void);
+void AudioResumeMusic(void);
+void AudioSetMusicVolume(float volume);
+
+// Veces que el stream se quedo sin datos: entre dos rellenos paso mas tiempo
+// del que duran los dos buffers
+int AudioUnderruns(void);
+
+// Crea un grupo de voces para sound (que sigue siendo de quien lo cargo);
+// devuelve su id, -1 si no hay sitio
+int AudioSoundPool(Sound sound);
+void AudioPlaySound(int pool, Vector2 position);
+// Lanza lo pedido en este frame; listener es la posicion del jugador
+void AudioFlushSounds(Vector2 listener);
+AudioVoiceStats AudioGetVoiceStats(void);
+
+#endif
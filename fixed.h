@@ -0,0 +1,66 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+// Aritmetica de punto fijo Q16.16 para la simulacion determinista.
+//
+// Las operaciones basicas de float (+, -, *, /, sqrtf) dan el mismo resultado
+// en cualquier CPU IEEE si el compilador no las fusiona (-ffp-contract=off),
+// pero sinf, cosf y atan2f dependen de la libm de cada plataforma: glibc,
+// bionic (Android) y la de MSVC no redondean igual. Aqui todo es entero:
+// senos y arcotangentes salen de tablas fijas interpoladas, asi que x86-64 y
+// ARM dan los mismos bits.
+//
+// Los angulos son binarios: una vuelta son FIXED_TURN unidades y se
+// envuelven solos con & (FIXED_TURN - 1).
+#include <stdint.h>
+
+typedef int32_t Fixed;
+
+#define FIXED_SHIFT 16
+#define FIXED_ONE (1 << FIXED_SHIFT)
+#define FIXED_MAX 32767.0f          // Mayor valor que se convierte desde float
+#define FIXED_TURN 65536            // Unidades de angulo por vuelta
+
+// float -> Q16.16 truncando (la escala es potencia de 2: el producto es exacto)
+static inline Fixed FixedFromFloat(float value)
+{
+    if (value > FIXED_MAX) value = FIXED_MAX;
+    if (value < -FIXED_MAX) value = -FIXED_MAX;
+    return (Fixed)(value*(float)FIXED_ONE);
+}
+
+// Exacto mientras |value| < 256 (24 bits de mantisa): sirve para direcciones
+static inline float FixedToFloat(Fixed value)
+{
+    return (float)value/(float)FIXED_ONE;
+}
+
+static inline Fixed FixedMul(Fixed a, Fixed b)
+{
+    return (Fixed)(((int64_t)a*b) >> FIXED_SHIFT);
+}
+
+static inline Fixed FixedDiv(Fixed a, Fixed b)
+{
+    return (Fixed)(((int64_t)a*FIXED_ONE)/b);
+}
+
+// Grados (float, sin limite de vueltas) -> angulo binario
+static inline int FixedAngleFromDegrees(float degrees)
+{
+    return (int)(degrees*((float)FIXED_TURN/360.0f)) & (FIXED_TURN - 1);
+}
+
+// Angulo binario con signo en (-FIXED_TURN/2, FIXED_TURN/2]
+static inline int FixedAngleWrap(int angle)
+{
+    angle &= FIXED_TURN - 1;
+    return (angle > FIXED_TURN/2)? angle - FIXED_TURN : angle;
+}
+
+Fixed FixedSin(int angle);
+Fixed FixedCos(int angle);
+// Angulo binario de (x, y) en [0, FIXED_TURN); 0 si los dos son 0
+int FixedAtan2(Fixed y, Fixed x);
+
+#endif
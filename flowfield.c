@@ -0,0 +1,182 @@
+#include "flowfield.h"
+
+// Vecinas en el orden en que se comparan: primero las rectas, asi en un
+// empate gana el paso recto
+static const int neighborX[8] = { 1, -1, 0, 0, 1, -1, 1, -1 };
+static const int neighborY[8] = { 0, 0, 1, -1, 1, 1, -1, -1 };
+
+static inline bool CellBlocked(const FlowField *field, int cx, int cy)
+{
+    if (cx < 0 || cx >= GRID_DIM || cy < 0 || cy >= GRID_DIM) return true;
+    return field->blocked[cy*GRID_DIM + cx];
+}
+
+void FlowFieldInit(FlowField *field, const Rectangle *obstacles, int count)
+{
+    for (int cy = 0; cy < GRID_DIM; cy++) {
+        for (int cx = 0; cx < GRID_DIM; cx++) {
+            float x = (cx + 0.5f)*GRID_CELL_SIZE - GRID_HALF_EXTENT;
+            float y = (cy + 0.5f)*GRID_CELL_SIZE - GRID_HALF_EXTENT;
+            bool inside = false;
+            for (int o = 0; o < count && !inside; o++) {
+                inside = x >= obstacles[o].x && x < obstacles[o].x + obstacles[o].width &&
+                         y >= obstacles[o].y && y < obstacles[o].y + obstacles[o].height;
+            }
+            field->blocked[cy*GRID_DIM + cx] = inside;
+        }
+    }
+
+    for (int cy = 0; cy < GRID_DIM; cy++) {
+        for (int cx = 0; cx < GRID_DIM; cx++) {
+            bool near = false;
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    int nx = cx + dx;
+                    int ny = cy + dy;
+                    if (nx >= 0 && nx < GRID_DIM && ny >= 0 && ny < GRID_DIM && field->blocked[ny*GRID_DIM + nx]) near = true;
+                }
+            }
+            field->nearObstacle[cy*GRID_DIM + cx] = near;
+        }
+    }
+
+    for (int cell = 0; cell < GRID_CELLS; cell++) {
+        field->dirX[0][cell] = field->dirY[0][cell] = 0.0f;
+        field->dirX[1][cell] = field->dirY[1][cell] = 0.0f;
+    }
+    field->active = 0;
+    field->target = -1;
+    field->pending = -1;
+}
+
+// 0, -1, +1, -2, +2... alrededor de center, sin salir de la rejilla
+static void OutwardOrder(int center, int *order)
+{
+    int n = 0;
+    order[n++] = center;
+    for (int d = 1; n < GRID_DIM; d++) {
+        if (center - d >= 0) order[n++] = center - d;
+        if (center + d < GRID_DIM) order[n++] = center + d;
+    }
+}
+
+static void StartBuild(FlowField *field, int target)
+{
+    for (int cell = 0; cell < GRID_CELLS; cell++) field->cost[cell] = FLOW_UNREACHED;
+    field->cost[target] = 0;
+    field->queue[0] = target;
+    field->queueHead = 0;
+    field->queueTail = 1;
+    field->cursor = 0;
+    field->pending = target;
+    OutwardOrder(target % GRID_DIM, field->columnOrder);
+    OutwardOrder(target / GRID_DIM, field->rowOrder);
+}
+
+// Un paso del BFS (4 vecinas): coste = pasos rectos hasta el objetivo
+static void IntegrateCell(FlowField *field)
+{
+    int cell = field->queue[field->queueHead++];
+    int cx = cell % GRID_DIM;
+    int cy = cell / GRID_DIM;
+    unsigned short next = field->cost[cell] + 1;
+
+    for (int n = 0; n < 4; n++) {
+        int nx = cx + neighborX[n];
+        int ny = cy + neighborY[n];
+        if (CellBlocked(field, nx, ny)) continue;
+        int neighbor = ny*GRID_DIM + nx;
+        if (field->cost[neighbor] != FLOW_UNREACHED) continue;
+        field->cost[neighbor] = next;
+        field->queue[field->queueTail++] = neighbor;
+    }
+}
+
+// Las celdas se recorren alejandose del objetivo, asi las vecinas que miran
+// hacia el ya tienen `clear` calculado
+static void DirectionCell(FlowField *field)
+{
+    int build = 1 - field->active;
+    int cx = field->columnOrder[field->cursor % GRID_DIM];
+    int cy = field->rowOrder[field->cursor / GRID_DIM];
+    int tx = field->pending % GRID_DIM;
+    int ty = field->pending / GRID_DIM;
+    int cell = cy*GRID_DIM + cx;
+    field->cursor++;
+
+    // Linea de vision por propagacion: se ve el objetivo si la celda esta
+    // libre y tambien la siguiente que cruza la recta hacia el (la vecina
+    // en el eje mas largo, o la diagonal si empatan). Es aproximada en las
+    // esquinas; el roce lo corrige PushOutOfObstacles
+    int dx = cx - tx;
+    int dy = cy - ty;
+    int sx = (dx > 0) - (dx < 0);
+    int sy = (dy > 0) - (dy < 0);
+    int adx = dx*sx;
+    int ady = dy*sy;
+    bool clear = !field->blocked[cell];
+    if (clear && adx > ady) clear = field->clear[cell - sx];
+    else if (clear && ady > adx) clear = field->clear[cell - sy*GRID_DIM];
+    else if (clear && adx > 0) {
+        clear = field->clear[cell - sx - sy*GRID_DIM] &&
+                !field->blocked[cell - sx] && !field->blocked[cell - sy*GRID_DIM];
+    }
+    field->clear[cell] = clear;
+
+    float dirX = 0.0f;
+    float dirY = 0.0f;
+    if (!clear && !field->blocked[cell] && field->cost[cell] != FLOW_UNREACHED) {
+        unsigned short best = field->cost[cell];
+        for (int n = 0; n < 8; n++) {
+            int nx = cx + neighborX[n];
+            int ny = cy + neighborY[n];
+            if (CellBlocked(field, nx, ny)) continue;
+            // En diagonal solo si no se corta la esquina de un obstaculo
+            if (n >= 4 && (CellBlocked(field, nx, cy) || CellBlocked(field, cx, ny))) continue;
+            unsigned short cost = field->cost[ny*GRID_DIM + nx];
+            if (cost < best) {
+                best = cost;
+                float scale = (n >= 4)? 0.70710678f : 1.0f;
+                dirX = neighborX[n]*scale;
+                dirY = neighborY[n]*scale;
+            }
+        }
+    }
+    field->dirX[build][cell] = dirX;
+    field->dirY[build][cell] = dirY;
+}
+
+void FlowFieldUpdate(FlowField *field, Vector2 target, int budget)
+{
+    int cell = GridCoord(target.y)*GRID_DIM + GridCoord(target.x);
+    int goal = (field->pending >= 0)? field->pending : field->target;
+    // Si cambia a mitad de camino se empieza de nuevo: lo hecho ya no sirve
+    if (cell != goal) StartBuild(field, cell);
+    if (field->pending < 0) return;
+
+    for (; budget > 0 && field->queueHead < field->queueTail; budget--) IntegrateCell(field);
+    for (; budget > 0 && field->cursor < GRID_CELLS; budget--) DirectionCell(field);
+
+    if (field->queueHead == field->queueTail && field->cursor == GRID_CELLS) {
+        field->active = 1 - field->active;
+        field->target = field->pending;
+        field->pending = -1;
+    }
+}
+
+int FlowFieldSample(const FlowField *field, const float *x, const float *y, int count,
+                    float *dirX, float *dirY, int *near)
+{
+    const float *fieldX = field->dirX[field->active];
+    const float *fieldY = field->dirY[field->active];
+    int nearCount = 0;
+
+    for (int i = 0; i < count; i++) {
+        // Fuera de la rejilla no hay obstaculos: en linea recta
+        int cell = FlowFieldCell(x[i], y[i]);
+        dirX[i] = (cell >= 0)? fieldX[cell] : 0.0f;
+        dirY[i] = (cell >= 0)? fieldY[cell] : 0.0f;
+        if (cell >= 0 && field->nearObstacle[cell]) near[nearCount++] = i;
+    }
+    return nearCount;
+}
@@ -0,0 +1,81 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+// Campo de flujo hacia el jugador, compartido por todos los enemigos, sobre
+// las mismas celdas que la rejilla de colisiones.
+//
+// La integracion es un BFS desde la celda del jugador que rodea las celdas
+// ocupadas por obstaculos; despues cada celda guarda la direccion a su
+// vecina (de 8) con menor coste. Las celdas con linea de vision hasta el
+// objetivo guardan (0, 0): ahi se va directo a la posicion del jugador.
+//
+// Solo se rehace cuando el jugador cambia de celda, y por trozos:
+// FlowFieldUpdate avanza como mucho `budget` celdas por llamada sobre un
+// segundo juego de direcciones, y el que usan los enemigos se cambia de
+// golpe cuando el nuevo esta completo. Mientras tanto siguen el anterior,
+// que lleva a una celda vecina de la del jugador.
+//
+// Los obstaculos deben estar alineados a la rejilla (multiplos de
+// GRID_CELL_SIZE): una celda esta ocupada si su centro cae dentro de alguno.
+#include "sim.h"
+#include "grid.h"
+
+#define FLOW_UNREACHED 0xFFFF
+
+typedef struct FlowField {
+    unsigned char blocked[GRID_CELLS];      // Dentro de un obstaculo
+    unsigned char nearObstacle[GRID_CELLS]; // Ocupada o vecina de una ocupada
+    float dirX[2][GRID_CELLS];              // Unitaria, o 0 para ir en linea recta
+    float dirY[2][GRID_CELLS];
+    int active;                             // Juego de direcciones en uso
+    int target;                             // Celda objetivo del campo en uso (-1 al inicio)
+
+    // Reconstruccion en curso
+    int pending;                            // Celda objetivo, -1 si no hay
+    unsigned short cost[GRID_CELLS];
+    unsigned char clear[GRID_CELLS];        // Linea de vision hasta el objetivo
+    int queue[GRID_CELLS];
+    int queueHead;
+    int queueTail;
+    int cursor;                             // Pasada de direcciones (en orden desde el objetivo)
+    int rowOrder[GRID_DIM];
+    int columnOrder[GRID_DIM];
+} FlowField;
+
+// Celda de un punto, o -1 fuera de la rejilla (ahi no hay obstaculos)
+static inline int FlowFieldCell(float x, float y)
+{
+    float fx = (x + GRID_HALF_EXTENT)*(1.0f/GRID_CELL_SIZE);
+    float fy = (y + GRID_HALF_EXTENT)*(1.0f/GRID_CELL_SIZE);
+    if (!(fx >= 0.0f && fx < GRID_DIM && fy >= 0.0f && fy < GRID_DIM)) return -1;
+    return (int)fy*GRID_DIM + (int)fx;
+}
+
+// Punto dentro de un obstaculo
+static inline bool FlowFieldBlocked(const FlowField *field, float x, float y)
+{
+    int cell = FlowFieldCell(x, y);
+    return cell >= 0 && field->blocked[cell];
+}
+
+// Un circulo de radio menor que una celda centrado aqui puede tocar un obstaculo
+static inline bool FlowFieldNearObstacle(const FlowField *field, float x, float y)
+{
+    int cell = FlowFieldCell(x, y);
+    return cell >= 0 && field->nearObstacle[cell];
+}
+
+extern FlowField flowField;
+
+// Marca las celdas ocupadas y deja el campo vacio (todos en linea recta)
+void FlowFieldInit(FlowField *field, const Rectangle *obstacles, int count);
+// Empieza a rehacer el campo si target cambio de celda y avanza la reconstruccion
+void FlowFieldUpdate(FlowField *field, Vector2 target, int budget);
+// Direccion del campo en cada posicion de [0, count), O(1) por posicion;
+// (0, 0) donde hay que ir en linea recta (lo resuelve SeekKernel). En near
+// deja, en orden, los indices que estan junto a un obstaculo: quien no lo
+// esta queda a mas de una celda y no llega a tocarlo en un tick.
+int FlowFieldSample(const FlowField *field, const float *x, const float *y, int count,
+                    float *dirX, float *dirY, int *near);
+
+#endif
@@ -0,0 +1,202 @@
+#include "grid.h"
+#include <stdlib.h>
+#include <string.h>
+
+void GridBuild(SpatialGrid *grid, const Enemies *enemies, int amount)
+{
+    int *cellStart = grid->cellStart;
+    int *itemCell = grid->itemCell;
+    memset(cellStart, 0, sizeof(grid->cellStart));
+
+    // Conteo por celda (desplazado una posicion para el prefijo)
+    for (int i = 0; i < amount; i++) {
+        itemCell[i] = -1;
+        if (!enemies->enabled[i]) continue;
+        int cell = GridCoord(enemies->y[i])*GRID_DIM + GridCoord(enemies->x[i]);
+        itemCell[i] = cell;
+        cellStart[cell + 1]++;
+    }
+    for (int c = 0; c < GRID_CELLS; c++) cellStart[c + 1] += cellStart[c];
+
+    // Reparto estable: dentro de cada celda los indices quedan ascendentes
+    static int cursor[GRID_CELLS];
+    memcpy(cursor, cellStart, sizeof(cursor));
+    for (int i = 0; i < amount; i++) {
+        if (itemCell[i] >= 0) grid->cellItems[cursor[itemCell[i]]++] = i;
+    }
+    grid->count = cellStart[GRID_CELLS];
+    grid->slack = 0.0f;
+}
+
+// Tramo de cellItems de una celda: sus indices ya estan en orden ascendente
+typedef struct GridRun {
+    int next;
+    int stop;
+} GridRun;
+
+#define GRID_MERGE_RUNS 256     // Celdas que se mezclan; con mas se ordena con qsort
+
+static int CompareIndices(const void *a, const void *b)
+{
+    int ia = *(const int *)a;
+    int ib = *(const int *)b;
+    return (ia > ib) - (ia < ib);
+}
+
+static inline void RunSiftDown(const int *items, GridRun *heap, int count, int at)
+{
+    GridRun run = heap[at];
+    int key = items[run.next];
+    for (;;) {
+        int child = 2*at + 1;
+        if (child >= count) break;
+        if (child + 1 < count && items[heap[child + 1].next] < items[heap[child].next]) child++;
+        if (items[heap[child].next] >= key) break;
+        heap[at] = heap[child];
+        at = child;
+    }
+    heap[at] = run;
+}
+
+int GridQueryCircle(const SpatialGrid *grid, Vector2 center, float radius, int *result, int maxResults)
+{
+    int minX, maxX, minY, maxY;
+    GridCircleCells(grid, center, radius, &minX, &maxX, &minY, &maxY);
+    const int *items = grid->cellItems;
+    int count = 0;
+
+    // Orden ascendente para resolver los impactos igual que el recorrido
+    // lineal. Cada celda ya viene ordenada: se mezclan sus tramos con un
+    // monticulo de cabezas, O(k log celdas) aunque la consulta cubra una
+    // multitud (salpicaduras, barridos largos)
+    if ((maxX - minX + 1)*(maxY - minY + 1) > GRID_MERGE_RUNS) {
+        for (int cy = minY; cy <= maxY; cy++) {
+            for (int cx = minX; cx <= maxX; cx++) {
+                int cell = cy*GRID_DIM + cx;
+                for (int k = grid->cellStart[cell]; k < grid->cellStart[cell + 1] && count < maxResults; k++) {
+                    result[count++] = items[k];
+                }
+            }
+        }
+        qsort(result, count, sizeof(int), CompareIndices);
+        return count;
+    }
+
+    GridRun heap[GRID_MERGE_RUNS];
+    int runs = 0;
+    for (int cy = minY; cy <= maxY; cy++) {
+        for (int cx = minX; cx <= maxX; cx++) {
+            int cell = cy*GRID_DIM + cx;
+            if (grid->cellStart[cell] < grid->cellStart[cell + 1]) {
+                heap[runs++] = (GridRun){ grid->cellStart[cell], grid->cellStart[cell + 1] };
+            }
+        }
+    }
+    for (int at = runs/2 - 1; at >= 0; at--) RunSiftDown(items, heap, runs, at);
+
+    while (runs > 0 && count < maxResults) {
+        result[count++] = items[heap[0].next++];
+        if (heap[0].next == heap[0].stop) {
+            heap[0] = heap[--runs];
+            if (runs == 0) break;
+        }
+        RunSiftDown(items, heap, runs, 0);
+    }
+    return count;
+}
+
+int GridEnemiesInCircle(const SpatialGrid *grid, const Enemies *enemies, Vector2 center, float radius,
+                        int *result, int maxResults)
+{
+    int count = GridQueryCircle(grid, center, radius + ENEMY_RADIUS, result, maxResults);
+    int inside = 0;
+
+    // Se filtra sobre el mismo arreglo: nunca se escribe por delante de lo leido
+    for (int c = 0; c < count; c++) {
+        int i = result[c];
+        if (!enemies->enabled[i]) continue;
+        float dx = enemies->x[i] - center.x;
+        float dy = enemies->y[i] - center.y;
+        float reach = radius + enemies->radius[i];
+        if (dx*dx + dy*dy <= reach*reach) result[inside++] = i;
+    }
+    return inside;
+}
+
+// Distancia minima desde center a cualquier enemigo de las celdas del anillo
+// ring: center esta en algun punto de su celda y los enemigos se han podido
+// mover slack desde GridBuild. Los que quedan fuera de la arena estan en las
+// celdas del borde, asi que solo pueden estar mas lejos de lo que dice.
+static inline float RingDistance(const SpatialGrid *grid, int ring)
+{
+    float distance = (ring - 1)*GRID_CELL_SIZE - grid->slack;
+    return (distance > 0.0f)? distance : 0.0f;
+}
+
+// Lista de los k mas cercanos, ordenada por (distancia, indice)
+typedef struct NearestList {
+    int *result;
+    float distance2[GRID_MAX_NEAREST];
+    int found;
+    int k;
+} NearestList;
+
+static void NearestCell(const SpatialGrid *grid, const Enemies *enemies, Vector2 center, float limit2,
+                        int cell, NearestList *list)
+{
+    for (int s = grid->cellStart[cell]; s < grid->cellStart[cell + 1]; s++) {
+        int i = grid->cellItems[s];
+        if (!enemies->enabled[i]) continue;
+        float dx = enemies->x[i] - center.x;
+        float dy = enemies->y[i] - center.y;
+        float distance2 = dx*dx + dy*dy;
+        if (distance2 > limit2) continue;
+
+        int at = list->found;
+        while (at > 0 && (list->distance2[at - 1] > distance2 ||
+                          (list->distance2[at - 1] == distance2 && list->result[at - 1] > i))) at--;
+        if (at >= list->k) continue;
+
+        int last = (list->found < list->k)? list->found++ : list->k - 1;
+        for (int m = last; m > at; m--) {
+            list->distance2[m] = list->distance2[m - 1];
+            list->result[m] = list->result[m - 1];
+        }
+        list->distance2[at] = distance2;
+        list->result[at] = i;
+    }
+}
+
+int GridNearest(const SpatialGrid *grid, const Enemies *enemies, Vector2 center, float maxDistance)
+{
+    int result;
+    return (GridKNearest(grid, enemies, center, maxDistance, 1, &result) > 0)? result : -1;
+}
+
+int GridKNearest(const SpatialGrid *grid, const Enemies *enemies, Vector2 center, float maxDistance,
+                 int k, int *result)
+{
+    NearestList list = { .result = result, .found = 0, .k = (k < GRID_MAX_NEAREST)? k : GRID_MAX_NEAREST };
+    if (list.k <= 0) return 0;
+
+    int cx = GridCoord(center.x);
+    int cy = GridCoord(center.y);
+    float limit2 = maxDistance*maxDistance;
+
+    for (int ring = 0; ring < GRID_DIM; ring++) {
+        // Con la lista llena, el k-esimo marca el limite
+        float bound = RingDistance(grid, ring);
+        float worst2 = (list.found == list.k)? list.distance2[list.k - 1] : limit2;
+        if (bound*bound > worst2) break;
+
+        for (int ry = cy - ring; ry <= cy + ring; ry++) {
+            if (ry < 0 || ry >= GRID_DIM) continue;
+            // Filas de arriba y abajo enteras; de las demas solo los extremos
+            int step = (ry == cy - ring || ry == cy + ring)? 1 : 2*ring;
+            for (int rx = cx - ring; rx <= cx + ring; rx += step) {
+                if (rx >= 0 && rx < GRID_DIM) NearestCell(grid, enemies, center, limit2, ry*GRID_DIM + rx, &list);
+            }
+        }
+    }
+    return list.found;
+}
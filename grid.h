@@ -0,0 +1,76 @@
+#ifndef GRID_H
+#define GRID_H
+
+// Rejilla uniforme sobre la arena (±2500) para consultas de colision.
+// Se reconstruye una vez por tick con un counting sort: cellStart/cellItems
+// guardan, por celda, los indices de enemigos que caen dentro. cellItems e
+// itemCell los pone quien crea los enemigos, con al menos tantos huecos como
+// enemigos (ver GrowEnemies en sim.c).
+#include "sim.h"
+
+#define GRID_CELL_SIZE 64.0f
+#define GRID_HALF_EXTENT 2560.0f
+#define GRID_DIM 80 // (2*GRID_HALF_EXTENT)/GRID_CELL_SIZE
+#define GRID_CELLS (GRID_DIM*GRID_DIM)
+#define GRID_MAX_NEAREST 16
+
+typedef struct SpatialGrid {
+    int cellStart[GRID_CELLS + 1];  // Inicio de cada celda en cellItems
+    int *cellItems;                 // Indices de enemigos ordenados por celda
+    int *itemCell;                  // Celda de cada enemigo (auxiliar de GridBuild)
+    int count;
+    float slack;                    // Cuanto se han movido como mucho desde GridBuild
+} SpatialGrid;
+
+// Celda de una coordenada; lo que queda fuera de la arena cae en el borde
+static inline int GridCoord(float v)
+{
+    int c = (int)((v + GRID_HALF_EXTENT)/GRID_CELL_SIZE);
+    if (c < 0) c = 0;
+    if (c >= GRID_DIM) c = GRID_DIM - 1;
+    return c;
+}
+
+// Celdas que toca un circulo, ampliado con slack (ver GridQueryCircle)
+static inline void GridCircleCells(const SpatialGrid *grid, Vector2 center, float radius,
+                                   int *minX, int *maxX, int *minY, int *maxY)
+{
+    radius += grid->slack;
+    *minX = GridCoord(center.x - radius);
+    *maxX = GridCoord(center.x + radius);
+    *minY = GridCoord(center.y - radius);
+    *maxY = GridCoord(center.y + radius);
+}
+
+static inline int GridCellCount(const SpatialGrid *grid, int cx, int cy)
+{
+    int cell = cy*GRID_DIM + cx;
+    return grid->cellStart[cell + 1] - grid->cellStart[cell];
+}
+
+extern SpatialGrid enemyGrid;
+
+void GridBuild(SpatialGrid *grid, const Enemies *enemies, int amount);
+// Candidatos (indices en orden ascendente) de las celdas que toca el circulo.
+// El radio debe incluir el radio de los enemigos; el test exacto lo hace quien llama.
+// Se amplia con slack para no perder enemigos movidos despues de GridBuild.
+int GridQueryCircle(const SpatialGrid *grid, Vector2 center, float radius, int *result, int maxResults);
+
+// Consultas exactas sobre los enemigos vivos (posiciones actuales). Solo
+// valen entre GridBuild y el siguiente EnemyFlush, que cambia los indices.
+// Los empates de distancia se resuelven por indice: el resultado no depende
+// del orden de recorrido.
+//
+// Enemigos cuyo circulo toca el circulo dado, en orden ascendente
+int GridEnemiesInCircle(const SpatialGrid *grid, const Enemies *enemies, Vector2 center, float radius,
+                        int *result, int maxResults);
+// Enemigo mas cercano a center a distancia <= maxDistance, o -1. Recorre
+// anillos de celdas hacia fuera y para en cuanto ninguna celda restante
+// puede tener uno mas cerca: el coste depende de la densidad local, no del
+// total de enemigos.
+int GridNearest(const SpatialGrid *grid, const Enemies *enemies, Vector2 center, float maxDistance);
+// Hasta k (<= GRID_MAX_NEAREST) mas cercanos, del mas cercano al mas lejano
+int GridKNearest(const SpatialGrid *grid, const Enemies *enemies, Vector2 center, float maxDistance,
+                 int k, int *result);
+
+#endif
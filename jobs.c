@@ -0,0 +1,295 @@
+#include "jobs.h"
+#include <stddef.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <sched.h>
+    #include <unistd.h>
+#endif
+
+#if defined(_MSC_VER)
+    #define JOB_THREAD_LOCAL __declspec(thread)
+#else
+    #define JOB_THREAD_LOCAL __thread
+#endif
+
+#define JOB_QUEUE_MASK (JOB_QUEUE_SIZE - 1)
+#define JOB_SPIN_COUNT 256      // Intentos antes de dormir un trabajador
+
+typedef struct Job {
+    JobFunc func;
+    void *data;
+    int begin;
+    int end;
+    int *remaining;             // Trozos pendientes del JobParallelFor que lo creo
+} Job;
+
+// Deque de Chase-Lev de tamaño fijo (Le, Pop, Cohen, Zappa Nardelli 2013).
+// top y bottom en lineas de cache distintas: los ladrones solo tocan top
+typedef struct JobQueue {
+    long long top;
+    char padding0[56];
+    long long bottom;
+    char padding1[56];
+    Job jobs[JOB_QUEUE_SIZE];
+} JobQueue;
+
+static JobQueue queues[JOB_MAX_THREADS];
+static int threadCount = 1;
+static JOB_THREAD_LOCAL int threadIndex = 0;
+static JOB_THREAD_LOCAL unsigned int stealSeed = 0;
+static int running = 0;
+
+// Los trabajadores sin nada que robar duermen hasta que cambia la generacion
+static unsigned int generation = 0;
+#if defined(_WIN32)
+    static HANDLE threads[JOB_MAX_THREADS];
+    static SRWLOCK sleepLock = SRWLOCK_INIT;
+    static CONDITION_VARIABLE sleepCondition = CONDITION_VARIABLE_INIT;
+#else
+    static pthread_t threads[JOB_MAX_THREADS];
+    static pthread_mutex_t sleepLock = PTHREAD_MUTEX_INITIALIZER;
+    static pthread_cond_t sleepCondition = PTHREAD_COND_INITIALIZER;
+#endif
+
+//----------------------------------------------------------------------------------
+// Cola
+//----------------------------------------------------------------------------------
+// Solo el dueño: false si la cola esta llena
+static bool QueuePush(JobQueue *queue, const Job *job)
+{
+    long long bottom = __atomic_load_n(&queue->bottom, __ATOMIC_RELAXED);
+    long long top = __atomic_load_n(&queue->top, __ATOMIC_ACQUIRE);
+    if (bottom - top >= JOB_QUEUE_SIZE) return false;
+
+    queue->jobs[bottom & JOB_QUEUE_MASK] = *job;
+    __atomic_store_n(&queue->bottom, bottom + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Solo el dueño: saca el ultimo que metio
+static bool QueuePop(JobQueue *queue, Job *job)
+{
+    long long bottom = __atomic_load_n(&queue->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&queue->bottom, bottom, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long long top = __atomic_load_n(&queue->top, __ATOMIC_RELAXED);
+
+    if (top > bottom) {
+        __atomic_store_n(&queue->bottom, bottom + 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    *job = queue->jobs[bottom & JOB_QUEUE_MASK];
+    if (top == bottom) {
+        // Ultimo elemento: compite con los ladrones
+        bool won = __atomic_compare_exchange_n(&queue->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+        __atomic_store_n(&queue->bottom, bottom + 1, __ATOMIC_RELAXED);
+        return won;
+    }
+    return true;
+}
+
+// Cualquier hilo: saca el mas antiguo
+static bool QueueSteal(JobQueue *queue, Job *job)
+{
+    long long top = __atomic_load_n(&queue->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long long bottom = __atomic_load_n(&queue->bottom, __ATOMIC_ACQUIRE);
+    if (top >= bottom) return false;
+
+    *job = queue->jobs[top & JOB_QUEUE_MASK];
+    return __atomic_compare_exchange_n(&queue->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+//----------------------------------------------------------------------------------
+// Ejecucion
+//----------------------------------------------------------------------------------
+static void RunJob(const Job *job)
+{
+    job->func(job->data, job->begin, job->end, threadIndex);
+    __atomic_fetch_sub(job->remaining, 1, __ATOMIC_RELEASE);
+}
+
+// Primero la cola propia, luego robar empezando por una victima al azar
+static bool FindJob(Job *job)
+{
+    if (QueuePop(&queues[threadIndex], job)) return true;
+
+    stealSeed ^= stealSeed << 13;
+    stealSeed ^= stealSeed >> 17;
+    stealSeed ^= stealSeed << 5;
+    int count = __atomic_load_n(&threadCount, __ATOMIC_RELAXED);
+    int first = (int)(stealSeed%(unsigned int)count);
+    for (int k = 0; k < count; k++) {
+        int victim = (first + k)%count;
+        if (victim != threadIndex && QueueSteal(&queues[victim], job)) return true;
+    }
+    return false;
+}
+
+static void JobYield(void)
+{
+#if defined(_WIN32)
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+static void WakeWorkers(void)
+{
+#if defined(_WIN32)
+    AcquireSRWLockExclusive(&sleepLock);
+    __atomic_fetch_add(&generation, 1, __ATOMIC_RELEASE);
+    WakeAllConditionVariable(&sleepCondition);
+    ReleaseSRWLockExclusive(&sleepLock);
+#else
+    pthread_mutex_lock(&sleepLock);
+    __atomic_fetch_add(&generation, 1, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&sleepCondition);
+    pthread_mutex_unlock(&sleepLock);
+#endif
+}
+
+static void WorkerSleep(unsigned int seen)
+{
+#if defined(_WIN32)
+    AcquireSRWLockExclusive(&sleepLock);
+    while (__atomic_load_n(&generation, __ATOMIC_ACQUIRE) == seen && __atomic_load_n(&running, __ATOMIC_ACQUIRE)) {
+        SleepConditionVariableSRW(&sleepCondition, &sleepLock, INFINITE, 0);
+    }
+    ReleaseSRWLockExclusive(&sleepLock);
+#else
+    pthread_mutex_lock(&sleepLock);
+    while (__atomic_load_n(&generation, __ATOMIC_ACQUIRE) == seen && __atomic_load_n(&running, __ATOMIC_ACQUIRE)) {
+        pthread_cond_wait(&sleepCondition, &sleepLock);
+    }
+    pthread_mutex_unlock(&sleepLock);
+#endif
+}
+
+static void WorkerLoop(int index)
+{
+    threadIndex = index;
+    stealSeed = 0x9E3779B9u*(unsigned int)(index + 1);
+
+    while (__atomic_load_n(&running, __ATOMIC_ACQUIRE)) {
+        unsigned int seen = __atomic_load_n(&generation, __ATOMIC_ACQUIRE);
+        Job job;
+        bool found = false;
+        for (int spin = 0; spin < JOB_SPIN_COUNT && !found; spin++) {
+            found = FindJob(&job);
+            if (!found) JobYield();
+        }
+        if (found) RunJob(&job);
+        else WorkerSleep(seen);
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI WorkerMain(LPVOID parameter)
+{
+    WorkerLoop((int)(size_t)parameter);
+    return 0;
+}
+#else
+static void *WorkerMain(void *parameter)
+{
+    WorkerLoop((int)(size_t)parameter);
+    return NULL;
+}
+#endif
+
+//----------------------------------------------------------------------------------
+// API
+//----------------------------------------------------------------------------------
+void JobSystemInit(int workers)
+{
+    if (running) return;
+
+    if (workers <= 0) {
+#if defined(_WIN32)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        workers = (int)info.dwNumberOfProcessors - 1;
+#else
+        workers = (int)sysconf(_SC_NPROCESSORS_ONLN) - 1;
+#endif
+    }
+    if (workers > JOB_MAX_THREADS - 1) workers = JOB_MAX_THREADS - 1;
+    if (workers <= 0) return;
+
+    threadIndex = 0;
+    stealSeed = 0x9E3779B9u;
+    running = 1;
+    threadCount = 1;
+    for (int i = 1; i <= workers; i++) {
+#if defined(_WIN32)
+        threads[i] = CreateThread(NULL, 0, WorkerMain, (LPVOID)(size_t)i, 0, NULL);
+        if (threads[i] == NULL) break;
+#else
+        if (pthread_create(&threads[i], NULL, WorkerMain, (void *)(size_t)i) != 0) break;
+#endif
+        __atomic_store_n(&threadCount, threadCount + 1, __ATOMIC_RELAXED);
+    }
+}
+
+void JobSystemShutdown(void)
+{
+    if (!running) return;
+
+    __atomic_store_n(&running, 0, __ATOMIC_RELEASE);
+    WakeWorkers();
+    for (int i = 1; i < threadCount; i++) {
+#if defined(_WIN32)
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+    threadCount = 1;
+}
+
+int JobThreadCount(void)
+{
+    return threadCount;
+}
+
+int JobThreadIndex(void)
+{
+    return threadIndex;
+}
+
+void JobParallelFor(int count, int chunkSize, JobFunc func, void *data)
+{
+    if (count <= 0) return;
+    if (chunkSize < 1) chunkSize = 1;
+
+    // Un solo trozo o sin trabajadores: en el acto, sin tocar las colas
+    if (threadCount == 1 || count <= chunkSize) {
+        for (int begin = 0; begin < count; begin += chunkSize) {
+            int end = (begin + chunkSize < count)? begin + chunkSize : count;
+            func(data, begin, end, threadIndex);
+        }
+        return;
+    }
+
+    int remaining = (count + chunkSize - 1)/chunkSize;
+    for (int begin = 0; begin < count; begin += chunkSize) {
+        Job job = { func, data, begin, (begin + chunkSize < count)? begin + chunkSize : count, &remaining };
+        if (!QueuePush(&queues[threadIndex], &job)) RunJob(&job);
+    }
+    WakeWorkers();
+
+    // Mientras quedan trozos, el que llama tambien trabaja
+    while (__atomic_load_n(&remaining, __ATOMIC_ACQUIRE) > 0) {
+        Job job;
+        if (FindJob(&job)) RunJob(&job);
+        else JobYield();
+    }
+}
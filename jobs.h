@@ -0,0 +1,33 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+// Sistema de tareas: un hilo trabajador por nucleo, cada uno con su cola
+// (deque de Chase-Lev). El dueño mete y saca por abajo; los hilos sin trabajo
+// roban por arriba de las colas de los demas.
+//
+//   JobParallelFor(count, 256, UpdateChunk, &data);
+//
+// parte [0, count) en trozos de 256 y vuelve cuando todos han terminado; el
+// hilo que llama tambien ejecuta trozos mientras espera. Cada trozo sabe su
+// rango, asi que puede escribir sus resultados en su propia parte de un
+// arreglo y fusionarlos luego en orden de trozo: el resultado no depende de
+// que hilo ejecuto que trozo.
+//
+// Sin JobSystemInit() (o con 0 trabajadores) todo corre en el hilo que llama.
+#include <stdbool.h>
+
+#define JOB_MAX_THREADS 64
+#define JOB_QUEUE_SIZE 1024     // Potencia de 2; si se llena el trozo corre en el acto
+
+// begin/end: rango del trozo; thread: 0 es el hilo principal, 1.. los trabajadores
+typedef void (*JobFunc)(void *data, int begin, int end, int thread);
+
+// workers = 0: uno menos que los nucleos disponibles (el principal tambien trabaja)
+void JobSystemInit(int workers);
+void JobSystemShutdown(void);
+int JobThreadCount(void);       // Trabajadores + hilo principal
+int JobThreadIndex(void);
+
+void JobParallelFor(int count, int chunkSize, JobFunc func, void *data);
+
+#endif
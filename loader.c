@@ -0,0 +1,292 @@
+#include "loader.h"
+#include "archive.h"
+#include <string.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI               // Choca con Rectangle de raylib
+    #define NOUSER              // Choca con CloseWindow/ShowCursor de raylib
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <time.h>
+    #include <unistd.h>
+#endif
+
+typedef enum LoaderKind {
+    LOADER_TEXTURE = 0,
+    LOADER_SPRITE,
+    LOADER_SOUND
+} LoaderKind;
+
+typedef enum LoaderState {
+    LOADER_QUEUED = 0,
+    LOADER_DECODED,     // Image/Wave listos, falta entregarlos
+    LOADER_DELIVERED
+} LoaderState;
+
+typedef struct LoaderRequest {
+    LoaderKind kind;
+    void *target;
+    char fileName[LOADER_PATH_LENGTH];
+    char fileType[16];  // Extension, la lee LoadImageFromMemory/LoadWaveFromMemory
+    Image image;
+    Wave wave;
+    bool mapped;        // Los datos son del archivo de recursos: no se liberan
+    int state;
+} LoaderRequest;
+
+static LoaderRequest requests[LOADER_MAX_REQUESTS];
+static int requestCount = 0;
+static int nextRequest = 0;     // Siguiente pedido sin decodificar (atomico)
+static int deliveredCount = 0;
+static int spritePending = 0;   // Sprites sin entregar: el atlas espera a que lleguen a 0
+static bool atlasBuilt = false;
+static int running = 0;
+static int threadCount = 0;
+static unsigned long long startTime = 0;
+
+#if defined(_WIN32)
+    static HANDLE threads[LOADER_MAX_THREADS];
+#else
+    static pthread_t threads[LOADER_MAX_THREADS];
+#endif
+
+static unsigned long long LoaderNow(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (unsigned long long)((double)counter.QuadPart*1e9/(double)frequency.QuadPart);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec*1000000000ull + (unsigned long long)now.tv_nsec;
+#endif
+}
+
+//----------------------------------------------------------------------------------
+// Pedidos
+//----------------------------------------------------------------------------------
+static void LoaderAdd(LoaderKind kind, void *target, const char *fileName)
+{
+    if (running || requestCount >= LOADER_MAX_REQUESTS) {
+        TraceLog(LOG_WARNING, "LOADER: No se puede pedir %s", fileName);
+        return;
+    }
+    LoaderRequest *request = &requests[requestCount++];
+    memset(request, 0, sizeof(*request));
+    request->kind = kind;
+    request->target = target;
+    // Se copian aqui: TextFormat/GetFileExtension usan buffers compartidos
+    // que no se pueden tocar desde los hilos
+    strncpy(request->fileName, fileName, LOADER_PATH_LENGTH - 1);
+    const char *extension = GetFileExtension(fileName);
+    if (extension != NULL) strncpy(request->fileType, extension, sizeof(request->fileType) - 1);
+    if (kind == LOADER_SPRITE) spritePending++;
+}
+
+void LoaderAddTexture(Texture2D *texture, const char *fileName)
+{
+    *texture = (Texture2D){ 0 };
+    LoaderAdd(LOADER_TEXTURE, texture, fileName);
+}
+
+void LoaderAddSprite(Sprite *sprite, const char *fileName)
+{
+    *sprite = (Sprite){ 0 };
+    LoaderAdd(LOADER_SPRITE, sprite, fileName);
+}
+
+void LoaderAddSound(Sound *sound, const char *fileName)
+{
+    *sound = (Sound){ 0 };
+    LoaderAdd(LOADER_SOUND, sound, fileName);
+}
+
+//----------------------------------------------------------------------------------
+// Decodificacion (cualquier hilo)
+//----------------------------------------------------------------------------------
+// Solo lectura de archivo y stb_*: nada de GPU ni de audio
+static bool DecodeNext(void)
+{
+    int index;
+    do {
+        index = __atomic_fetch_add(&nextRequest, 1, __ATOMIC_RELAXED);
+        if (index >= requestCount) return false;
+    } while (requests[index].state != LOADER_QUEUED);   // Ya sacado del archivo
+
+    LoaderRequest *request = &requests[index];
+    int size = 0;
+    unsigned char *data = LoadFileData(request->fileName, &size);
+    if (data != NULL) {
+        if (request->kind == LOADER_SOUND) request->wave = LoadWaveFromMemory(request->fileType, data, size);
+        else request->image = LoadImageFromMemory(request->fileType, data, size);
+        UnloadFileData(data);
+    }
+    __atomic_store_n(&request->state, LOADER_DECODED, __ATOMIC_RELEASE);
+    return true;
+}
+
+static void WorkerLoop(void)
+{
+    while (__atomic_load_n(&running, __ATOMIC_ACQUIRE) && DecodeNext()) { }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI WorkerMain(LPVOID parameter)
+{
+    (void)parameter;
+    WorkerLoop();
+    return 0;
+}
+#else
+static void *WorkerMain(void *parameter)
+{
+    (void)parameter;
+    WorkerLoop();
+    return NULL;
+}
+#endif
+
+void LoaderStart(int count)
+{
+    if (running) return;
+
+    if (count <= 0) {
+        // El principal esta ocupado creando la ventana: todos los nucleos
+#if defined(_WIN32)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        count = (int)info.dwNumberOfProcessors;
+#else
+        count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    }
+    startTime = LoaderNow();
+
+    // Lo que esta en el archivo de recursos ya esta decodificado
+    int mappedCount = 0;
+    for (int i = 0; i < requestCount; i++) {
+        LoaderRequest *request = &requests[i];
+        if (request->kind == LOADER_SOUND) request->mapped = ArchiveWave(request->fileName, &request->wave);
+        else request->mapped = ArchiveImage(request->fileName, &request->image);
+        if (request->mapped) {
+            request->state = LOADER_DECODED;
+            mappedCount++;
+        }
+    }
+
+    if (count > LOADER_MAX_THREADS) count = LOADER_MAX_THREADS;
+    if (count > requestCount - mappedCount) count = requestCount - mappedCount;
+
+    running = 1;
+    threadCount = 0;
+    for (int i = 0; i < count; i++) {
+#if defined(_WIN32)
+        threads[i] = CreateThread(NULL, 0, WorkerMain, NULL, 0, NULL);
+        if (threads[i] == NULL) break;
+#else
+        if (pthread_create(&threads[i], NULL, WorkerMain, NULL) != 0) break;
+#endif
+        threadCount++;
+    }
+    TraceLog(LOG_INFO, "LOADER: %d recursos (%d del archivo), %d hilos", requestCount, mappedCount, threadCount);
+}
+
+//----------------------------------------------------------------------------------
+// Entrega (hilo principal)
+//----------------------------------------------------------------------------------
+static void Deliver(LoaderRequest *request)
+{
+    bool decoded = (request->kind == LOADER_SOUND)? request->wave.data != NULL : request->image.data != NULL;
+    if (!decoded) TraceLog(LOG_WARNING, "LOADER: No se pudo cargar %s", request->fileName);
+
+    switch (request->kind) {
+        case LOADER_TEXTURE:
+            // Desde el archivo se sube directamente del mapeo
+            if (decoded) *(Texture2D *)request->target = LoadTextureFromImage(request->image);
+            if (decoded && !request->mapped) UnloadImage(request->image);
+            break;
+        case LOADER_SPRITE:
+            // El atlas se queda con la imagen (y la libera): del mapeo va una copia
+            if (decoded && request->mapped) request->image = ImageCopy(request->image);
+            if (decoded) AtlasAddImage((Sprite *)request->target, request->image);
+            spritePending--;
+            break;
+        case LOADER_SOUND:
+            if (decoded) *(Sound *)request->target = LoadSoundFromWave(request->wave);
+            if (decoded && !request->mapped) UnloadWave(request->wave);
+            break;
+    }
+    request->image = (Image){ 0 };
+    request->wave = (Wave){ 0 };
+    request->state = LOADER_DELIVERED;
+    deliveredCount++;
+}
+
+bool LoaderUpdate(double budget)
+{
+    if (atlasBuilt) return true;
+
+    unsigned long long deadline = LoaderNow() + (unsigned long long)(budget*1e9);
+    int delivered = 0;
+
+    // Sin hilos (no se pudieron crear) se decodifica aqui, dentro del presupuesto
+    if (threadCount == 0) {
+        while ((delivered == 0 || LoaderNow() < deadline) && DecodeNext()) delivered++;
+    }
+
+    for (int i = 0; i < requestCount; i++) {
+        LoaderRequest *request = &requests[i];
+        if (__atomic_load_n(&request->state, __ATOMIC_ACQUIRE) != LOADER_DECODED) continue;
+        if (delivered > 0 && LoaderNow() >= deadline) return false;
+        Deliver(request);
+        delivered++;
+    }
+
+    // El atlas es una sola subida grande: en un frame propio
+    if (deliveredCount < requestCount || spritePending > 0) return false;
+    if (delivered > 0 && LoaderNow() >= deadline) return false;
+    AtlasBuild();
+    atlasBuilt = true;
+    ArchiveClose();     // Ya se ha copiado todo lo que venia de ahi
+    TraceLog(LOG_INFO, "LOADER: Carga completa en %.1f ms", LoaderElapsed()*1000.0);
+    return true;
+}
+
+float LoaderProgress(void)
+{
+    // El atlas cuenta como un paso mas
+    return (float)(deliveredCount + (atlasBuilt? 1 : 0))/(float)(requestCount + 1);
+}
+
+double LoaderElapsed(void)
+{
+    return (double)(LoaderNow() - startTime)*1e-9;
+}
+
+void LoaderShutdown(void)
+{
+    // Los hilos terminan lo que estan decodificando y no cogen mas
+    __atomic_store_n(&running, 0, __ATOMIC_RELEASE);
+    for (int i = 0; i < threadCount; i++) {
+#if defined(_WIN32)
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+    threadCount = 0;
+
+    for (int i = 0; i < requestCount; i++) {
+        if (requests[i].state != LOADER_DECODED || requests[i].mapped) continue;
+        if (requests[i].image.data != NULL) UnloadImage(requests[i].image);
+        if (requests[i].wave.data != NULL) UnloadWave(requests[i].wave);
+        requests[i].state = LOADER_DELIVERED;
+    }
+    ArchiveClose();
+}
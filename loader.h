@@ -0,0 +1,48 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+// Carga de recursos en segundo plano: los archivos se leen y se decodifican
+// (PNG/JPG a Image, OGG/WAV a Wave) en hilos propios, y el hilo principal
+// solo sube a la GPU (o al dispositivo de audio) lo que ya esta listo, con un
+// limite de tiempo por frame. Asi la ventana se abre y pinta mientras carga.
+//
+//   LoaderAddTexture(&bgFrames[0], "textures/background/1 (1).png");
+//   LoaderAddSprite(&bullet, "textures/bullet.png");
+//   LoaderStart(0);                 // Antes de InitWindow: decodifica mientras
+//   InitWindow(...);                // se crea la ventana
+//   while (!LoaderUpdate(0.004)) { ...dibujar pantalla de carga... }
+//
+// Si hay un archivo de recursos abierto (ArchiveOpen) lo que este dentro no
+// pasa por los hilos: se sube directamente desde el mapeo, que se cierra al
+// terminar la carga.
+//
+// Los pedidos se registran antes de LoaderStart(); el destino (Texture2D,
+// Sprite, Sound) no es valido hasta que LoaderUpdate() lo entrega. Los
+// sprites van al atlas, que se construye en una sola llamada cuando estan
+// todos. Si un archivo falla queda el destino a 0 y se avisa por TraceLog
+// (assets.c pone entonces su recurso de reserva).
+#include "raylib.h"
+#include "atlas.h"
+#include <stdbool.h>
+
+#define LOADER_MAX_REQUESTS 128
+#define LOADER_MAX_THREADS 8
+#define LOADER_PATH_LENGTH 128
+#define LOADER_FRAME_BUDGET 0.004   // Segundos de subidas por frame
+
+void LoaderAddTexture(Texture2D *texture, const char *fileName);
+void LoaderAddSprite(Sprite *sprite, const char *fileName);
+void LoaderAddSound(Sound *sound, const char *fileName);
+
+// threads = 0: uno por nucleo (hasta LOADER_MAX_THREADS)
+void LoaderStart(int threads);
+// Solo en el hilo principal, con la ventana (y el audio) ya creados. Entrega
+// lo decodificado hasta gastar budget segundos (al menos un recurso);
+// devuelve true cuando todo esta entregado y el atlas construido
+bool LoaderUpdate(double budget);
+float LoaderProgress(void);     // 0..1
+double LoaderElapsed(void);     // Segundos desde LoaderStart()
+// Espera a los hilos y libera lo que no se llego a entregar
+void LoaderShutdown(void);
+
+#endif
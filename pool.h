@@ -0,0 +1,78 @@
+#ifndef POOL_H
+#define POOL_H
+
+// Pool de indices con lista densa de activos.
+// dense guarda una permutacion de todos los slots: [0, count) son los activos
+// y [count, capacity) hace de lista libre. position[slot] dice donde esta cada
+// slot dentro de dense, asi que obtener y liberar son O(1) y los bucles solo
+// recorren los activos. Para liberar mientras se recorre, recorrer dense de
+// atras hacia adelante: el slot que ocupa el hueco ya fue visitado o es nuevo.
+#include <stdbool.h>
+
+typedef struct IndexPool {
+    int *dense;
+    int *position;
+    int capacity;
+    int count;
+} IndexPool;
+
+static inline void PoolInit(IndexPool *pool, int *dense, int *position, int capacity)
+{
+    pool->dense = dense;
+    pool->position = position;
+    pool->capacity = capacity;
+    pool->count = 0;
+    for (int i = 0; i < capacity; i++) {
+        dense[i] = i;
+        position[i] = i;
+    }
+}
+
+// Pasa a un almacen mayor conservando los slots activos: se copia la
+// permutacion y los slots nuevos se añaden al final de la lista libre
+static inline void PoolGrow(IndexPool *pool, int *dense, int *position, int capacity)
+{
+    for (int i = 0; i < pool->capacity; i++) {
+        dense[i] = pool->dense[i];
+        position[i] = pool->position[i];
+    }
+    for (int i = pool->capacity; i < capacity; i++) {
+        dense[i] = i;
+        position[i] = i;
+    }
+    pool->dense = dense;
+    pool->position = position;
+    pool->capacity = capacity;
+}
+
+// Libera todos los slots (la permutacion sigue siendo valida)
+static inline void PoolClear(IndexPool *pool)
+{
+    pool->count = 0;
+}
+
+// Devuelve un slot libre o -1 si el pool esta lleno
+static inline int PoolAcquire(IndexPool *pool)
+{
+    if (pool->count >= pool->capacity) return -1;
+    return pool->dense[pool->count++];
+}
+
+static inline bool PoolIsActive(const IndexPool *pool, int slot)
+{
+    return pool->position[slot] < pool->count;
+}
+
+static inline void PoolRelease(IndexPool *pool, int slot)
+{
+    int at = pool->position[slot];
+    if (at >= pool->count) return; // Ya estaba libre
+
+    int last = pool->dense[--pool->count];
+    pool->dense[at] = last;
+    pool->position[last] = at;
+    pool->dense[pool->count] = slot;
+    pool->position[slot] = pool->count;
+}
+
+#endif
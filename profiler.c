@@ -0,0 +1,255 @@
+#include "profiler.h"
+
+#if defined(PROFILER)
+
+#include <stdio.h>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+#if defined(_MSC_VER)
+    #define PROFILER_THREAD_LOCAL __declspec(thread)
+#else
+    #define PROFILER_THREAD_LOCAL __thread
+#endif
+
+#define PROFILER_RING_SIZE 16384   // Potencia de 2
+#define PROFILER_RING_MASK (PROFILER_RING_SIZE - 1)
+
+static const char *zoneNames[PROFILE_ZONE_COUNT] = {
+    "SimStep",
+    "Spawn",
+    "UpdateProjectiles",
+    "OrbCollision",
+    "FlowField",
+    "EnemyCollision",
+    "GridBuild",
+    "Separation",
+    "ProjectileCollision",
+    "Animations",
+    "DrawBackground",
+    "DrawOrbs",
+    "DrawEnemies",
+    "DrawProjectiles",
+    "DrawPlayer",
+    "UI",
+    "EndDrawing"
+};
+
+// Buffer circular: cada escritor reserva un indice con un fetch_add y publica
+// el evento escribiendo sequence = indice + 1 al final. Quien lee descarta
+// los huecos cuyo sequence no coincide (a medio escribir o ya pisados).
+static ProfileEvent ring[PROFILER_RING_SIZE];
+static unsigned int ringHead = 0;
+
+// Hilos: id corto para el trace y profundidad de anidamiento
+static unsigned int threadCount = 0;
+static PROFILER_THREAD_LOCAL int threadId = -1;
+static PROFILER_THREAD_LOCAL int threadDepth = 0;
+
+// Acumulado del frame en curso e historial por zona
+static unsigned long long zoneFrameNs[PROFILE_ZONE_COUNT];
+static unsigned long long zoneHistory[PROFILE_ZONE_COUNT][PROFILER_HISTORY];
+static int historyCursor = 0;
+static int historyCount = 0;
+static unsigned long long zoneTotalNs[PROFILE_ZONE_COUNT];
+static int frameCount = 0;
+
+// Limites del ultimo frame completo (tiempo e indices del buffer)
+static unsigned long long frameStart = 0;
+static unsigned int frameStartIndex = 0;
+static unsigned long long lastFrameStart = 0;
+static unsigned long long lastFrameEnd = 0;
+static unsigned int lastFrameBeginIndex = 0;
+static unsigned int lastFrameEndIndex = 0;
+
+unsigned long long ProfilerNow(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (unsigned long long)((double)counter.QuadPart*1e9/(double)frequency.QuadPart);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec*1000000000ull + (unsigned long long)now.tv_nsec;
+#endif
+}
+
+ProfileScope ProfileBegin(ProfileZone zone)
+{
+    ProfileScope scope;
+    scope.zone = zone;
+    scope.open = true;
+    threadDepth++;
+    scope.start = ProfilerNow();
+    return scope;
+}
+
+void ProfileEnd(ProfileScope *scope)
+{
+    unsigned long long end = ProfilerNow();
+    scope->open = false;
+    threadDepth--;
+
+    if (threadId < 0) threadId = (int)__atomic_fetch_add(&threadCount, 1, __ATOMIC_RELAXED);
+
+    unsigned int index = __atomic_fetch_add(&ringHead, 1, __ATOMIC_RELAXED);
+    ProfileEvent *event = &ring[index & PROFILER_RING_MASK];
+    __atomic_store_n(&event->sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    event->start = scope->start;
+    event->end = end;
+    event->zone = (unsigned short)scope->zone;
+    event->depth = (unsigned char)((threadDepth < PROFILER_MAX_DEPTH)? threadDepth : PROFILER_MAX_DEPTH - 1);
+    event->thread = (unsigned char)threadId;
+    __atomic_store_n(&event->sequence, index + 1, __ATOMIC_RELEASE);
+
+    __atomic_fetch_add(&zoneFrameNs[scope->zone], end - scope->start, __ATOMIC_RELAXED);
+}
+
+// Copia el evento 'index' si sigue intacto en el buffer
+static bool ReadEvent(unsigned int index, ProfileEvent *out)
+{
+    const ProfileEvent *event = &ring[index & PROFILER_RING_MASK];
+    if (__atomic_load_n(&event->sequence, __ATOMIC_ACQUIRE) != index + 1) return false;
+    *out = *event;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&event->sequence, __ATOMIC_RELAXED) == index + 1;
+}
+
+void ProfilerFrameEnd(void)
+{
+    unsigned long long now = ProfilerNow();
+    unsigned int head = __atomic_load_n(&ringHead, __ATOMIC_ACQUIRE);
+
+    if (frameStart != 0) {
+        lastFrameStart = frameStart;
+        lastFrameEnd = now;
+        lastFrameBeginIndex = frameStartIndex;
+        lastFrameEndIndex = head;
+
+        for (int z = 0; z < PROFILE_ZONE_COUNT; z++) {
+            zoneHistory[z][historyCursor] = __atomic_exchange_n(&zoneFrameNs[z], 0, __ATOMIC_RELAXED);
+            zoneTotalNs[z] += zoneHistory[z][historyCursor];
+        }
+        frameCount++;
+        historyCursor = (historyCursor + 1)%PROFILER_HISTORY;
+        if (historyCount < PROFILER_HISTORY) historyCount++;
+    } else {
+        for (int z = 0; z < PROFILE_ZONE_COUNT; z++) __atomic_store_n(&zoneFrameNs[z], 0, __ATOMIC_RELAXED);
+    }
+
+    frameStart = now;
+    frameStartIndex = head;
+}
+
+const char *ProfilerZoneName(int zone)
+{
+    return (zone >= 0 && zone < PROFILE_ZONE_COUNT)? zoneNames[zone] : "?";
+}
+
+ProfileZoneStats ProfilerGetZoneStats(int zone)
+{
+    ProfileZoneStats stats = { 0 };
+    unsigned long long total = 0;
+    unsigned long long max = 0;
+
+    for (int k = 0; k < historyCount; k++) {
+        unsigned long long ns = zoneHistory[zone][k];
+        if (ns == 0) continue;
+
+        unsigned long long us = ns/1000;
+        int bucket = 0;
+        while (us >= 2 && bucket < PROFILER_BUCKETS - 1) {
+            us >>= 1;
+            bucket++;
+        }
+        stats.buckets[bucket]++;
+        stats.samples++;
+        total += ns;
+        if (ns > max) max = ns;
+    }
+
+    if (stats.samples > 0) stats.averageMs = (double)total/stats.samples/1e6;
+    stats.maxMs = (double)max/1e6;
+    if (historyCount > 0) {
+        stats.lastMs = (double)zoneHistory[zone][(historyCursor + PROFILER_HISTORY - 1)%PROFILER_HISTORY]/1e6;
+    }
+    return stats;
+}
+
+unsigned long long ProfilerZoneTotalNs(int zone)
+{
+    return zoneTotalNs[zone];
+}
+
+int ProfilerFrameCount(void)
+{
+    return frameCount;
+}
+
+void ProfilerReset(void)
+{
+    for (int z = 0; z < PROFILE_ZONE_COUNT; z++) {
+        zoneTotalNs[z] = 0;
+        for (int k = 0; k < PROFILER_HISTORY; k++) zoneHistory[z][k] = 0;
+    }
+    historyCursor = 0;
+    historyCount = 0;
+    frameCount = 0;
+}
+
+int ProfilerLastFrame(ProfileEvent *events, int maxEvents, unsigned long long *start, unsigned long long *end)
+{
+    unsigned int first = lastFrameBeginIndex;
+    if (lastFrameEndIndex - first > PROFILER_RING_SIZE) first = lastFrameEndIndex - PROFILER_RING_SIZE;
+
+    int count = 0;
+    for (unsigned int i = first; i != lastFrameEndIndex && count < maxEvents; i++) {
+        if (ReadEvent(i, &events[count])) count++;
+    }
+    *start = lastFrameStart;
+    *end = lastFrameEnd;
+    return count;
+}
+
+bool ProfilerDumpTrace(const char *fileName)
+{
+    FILE *file = fopen(fileName, "w");
+    if (file == NULL) return false;
+
+    unsigned int head = __atomic_load_n(&ringHead, __ATOMIC_ACQUIRE);
+    unsigned int first = (head > PROFILER_RING_SIZE)? head - PROFILER_RING_SIZE : 0;
+    unsigned long long origin = 0;
+    int written = 0;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"main\"}}");
+    for (unsigned int i = first; i != head; i++) {
+        ProfileEvent event;
+        if (!ReadEvent(i, &event)) continue;
+        if (origin == 0 || event.start < origin) origin = event.start;
+    }
+    for (unsigned int i = first; i != head; i++) {
+        ProfileEvent event;
+        if (!ReadEvent(i, &event)) continue;
+        // Chrome trace usa microsegundos
+        fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                ProfilerZoneName(event.zone), event.thread,
+                (double)(event.start - origin)/1000.0, (double)(event.end - event.start)/1000.0);
+        written++;
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    printf("PROFILER: %d eventos en %s\n", written, fileName);
+    return true;
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Zonas de perfilado: miden cuanto tarda cada fase del frame.
+//
+//   PROFILE_ZONE(PROFILE_ENEMY_COLLISION) {
+//       EnemyCollision(&enemies);
+//   }
+//
+// Cada zona cerrada se escribe en un buffer circular sin locks (varios hilos
+// pueden escribir a la vez). El overlay lee de ahi el ultimo frame y un
+// historial por zona, y ProfilerDumpTrace() lo vuelca en formato Chrome
+// trace (chrome://tracing o ui.perfetto.dev).
+//
+// Solo existe si se compila con -DPROFILER (make USE_PROFILER=TRUE): sin
+// esa bandera las macros desaparecen y no queda ni una instruccion.
+// Ojo: un return o break dentro de PROFILE_ZONE deja la zona sin cerrar.
+#include <stdbool.h>
+
+typedef enum ProfileZone {
+    PROFILE_SIM_STEP = 0,
+    PROFILE_SPAWN,
+    PROFILE_UPDATE_PROJECTILES,
+    PROFILE_ORB_COLLISION,
+    PROFILE_FLOW_FIELD,
+    PROFILE_ENEMY_COLLISION,
+    PROFILE_GRID_BUILD,
+    PROFILE_SEPARATION,
+    PROFILE_PROJECTILE_COLLISION,
+    PROFILE_ANIMATIONS,
+    PROFILE_DRAW_BACKGROUND,
+    PROFILE_DRAW_ORBS,
+    PROFILE_DRAW_ENEMIES,
+    PROFILE_DRAW_PROJECTILES,
+    PROFILE_DRAW_PLAYER,
+    PROFILE_UI,
+    PROFILE_END_DRAWING,
+    PROFILE_ZONE_COUNT
+} ProfileZone;
+
+#define PROFILER_HISTORY 120        // Frames del historial por zona
+#define PROFILER_BUCKETS 16         // Histograma log2 en microsegundos
+#define PROFILER_MAX_DEPTH 8
+
+#if defined(PROFILER)
+
+typedef struct ProfileScope {
+    unsigned long long start;
+    int zone;
+    bool open;
+} ProfileScope;
+
+typedef struct ProfileEvent {
+    unsigned long long start;      // ns
+    unsigned long long end;
+    unsigned short zone;
+    unsigned char depth;           // Anidamiento dentro del hilo
+    unsigned char thread;
+    unsigned int sequence;         // Uso interno del buffer circular
+} ProfileEvent;
+
+typedef struct ProfileZoneStats {
+    double averageMs;
+    double maxMs;
+    double lastMs;
+    int samples;                   // Frames del historial en que la zona corrio
+    int buckets[PROFILER_BUCKETS]; // [0]: <2us, [b]: [2^b, 2^(b+1)) us
+} ProfileZoneStats;
+
+#define PROFILE_ZONE(zone) for (ProfileScope profileScope_ = ProfileBegin(zone); profileScope_.open; ProfileEnd(&profileScope_))
+#define PROFILE_FRAME_END() ProfilerFrameEnd()
+
+unsigned long long ProfilerNow(void);
+ProfileScope ProfileBegin(ProfileZone zone);
+void ProfileEnd(ProfileScope *scope);
+
+// Cierra el frame: pasa los acumulados por zona al historial
+void ProfilerFrameEnd(void);
+const char *ProfilerZoneName(int zone);
+ProfileZoneStats ProfilerGetZoneStats(int zone);
+// Acumulados desde el inicio o el ultimo ProfilerReset() (benchmarks)
+unsigned long long ProfilerZoneTotalNs(int zone);
+int ProfilerFrameCount(void);
+void ProfilerReset(void);
+// Eventos del ultimo frame completo; devuelve cuantos se copiaron
+int ProfilerLastFrame(ProfileEvent *events, int maxEvents, unsigned long long *frameStart, unsigned long long *frameEnd);
+bool ProfilerDumpTrace(const char *fileName);
+
+#else
+
+#define PROFILE_ZONE(zone)
+#define PROFILE_FRAME_END() ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,143 @@
+#include "replay.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct ReplayHeader {
+    char magic[4];              // "RPLY"
+    unsigned int version;
+    unsigned int seed;
+    unsigned int tickCount;     // 0 si la grabacion no se cerro bien
+    unsigned int mode;          // SimMode
+    char math[8];               // SimMathName() al grabar
+} ReplayHeader;
+
+// Un tick grabado (20 bytes)
+typedef struct ReplayTick {
+    float dt;
+    float aimX;
+    float aimY;
+    unsigned int checksum;      // SimChecksum() despues del tick
+    unsigned char buttons;
+    unsigned char upgradeChoice;
+    unsigned char padding[2];
+} ReplayTick;
+
+enum {
+    REPLAY_UP = 1 << 0,
+    REPLAY_DOWN = 1 << 1,
+    REPLAY_LEFT = 1 << 2,
+    REPLAY_RIGHT = 1 << 3,
+    REPLAY_SHOOT = 1 << 4,
+    REPLAY_SPAWN_ORB = 1 << 5,
+    REPLAY_RESTART = 1 << 6,
+    REPLAY_CLOSE_MENU = 1 << 7
+};
+
+static FILE *recordFile = NULL;
+static ReplayHeader recordHeader = { 0 };
+
+//----------------------------------------------------------------------------------
+// Grabacion
+//----------------------------------------------------------------------------------
+bool ReplayRecordBegin(const char *fileName, unsigned int seed)
+{
+    if (recordFile != NULL) ReplayRecordEnd();
+
+    recordFile = fopen(fileName, "wb");
+    if (recordFile == NULL) return false;
+
+    memcpy(recordHeader.magic, "RPLY", 4);
+    recordHeader.version = REPLAY_VERSION;
+    recordHeader.seed = seed;
+    recordHeader.tickCount = 0;
+    recordHeader.mode = (unsigned int)simMode;
+    memset(recordHeader.math, 0, sizeof(recordHeader.math));
+    strncpy(recordHeader.math, SimMathName(), sizeof(recordHeader.math) - 1);
+    fwrite(&recordHeader, sizeof(recordHeader), 1, recordFile);
+    return true;
+}
+
+void ReplayRecordTick(const SimInput *input, float dt, unsigned int checksum)
+{
+    if (recordFile == NULL) return;
+
+    ReplayTick tick = { 0 };
+    tick.dt = dt;
+    tick.aimX = input->aim.x;
+    tick.aimY = input->aim.y;
+    tick.checksum = checksum;
+    tick.upgradeChoice = (unsigned char)input->upgradeChoice;
+    if (input->up) tick.buttons |= REPLAY_UP;
+    if (input->down) tick.buttons |= REPLAY_DOWN;
+    if (input->left) tick.buttons |= REPLAY_LEFT;
+    if (input->right) tick.buttons |= REPLAY_RIGHT;
+    if (input->shoot) tick.buttons |= REPLAY_SHOOT;
+    if (input->spawnOrb) tick.buttons |= REPLAY_SPAWN_ORB;
+    if (input->restart) tick.buttons |= REPLAY_RESTART;
+    if (input->closeMenu) tick.buttons |= REPLAY_CLOSE_MENU;
+
+    fwrite(&tick, sizeof(tick), 1, recordFile);
+    recordHeader.tickCount++;
+}
+
+void ReplayRecordEnd(void)
+{
+    if (recordFile == NULL) return;
+
+    fseek(recordFile, 0, SEEK_SET);
+    fwrite(&recordHeader, sizeof(recordHeader), 1, recordFile);
+    fclose(recordFile);
+    recordFile = NULL;
+}
+
+//----------------------------------------------------------------------------------
+// Repeticion
+//----------------------------------------------------------------------------------
+bool ReplayRun(const char *fileName, ReplayResult *result)
+{
+    *result = (ReplayResult){ 0 };
+    result->desyncTick = -1;
+
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return false;
+
+    ReplayHeader header = { 0 };
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, "RPLY", 4) != 0 ||
+        header.version != REPLAY_VERSION || strncmp(header.math, SimMathName(), sizeof(header.math)) != 0) {
+        fclose(file);
+        return false;
+    }
+
+    SimSetMode((SimMode)header.mode);
+    SimInit(header.seed);
+
+    // Se lee hasta el final aunque tickCount sea 0 (partida que no se cerro)
+    ReplayTick tick;
+    while (fread(&tick, sizeof(tick), 1, file) == 1) {
+        SimInput input = { 0 };
+        input.up = (tick.buttons & REPLAY_UP) != 0;
+        input.down = (tick.buttons & REPLAY_DOWN) != 0;
+        input.left = (tick.buttons & REPLAY_LEFT) != 0;
+        input.right = (tick.buttons & REPLAY_RIGHT) != 0;
+        input.shoot = (tick.buttons & REPLAY_SHOOT) != 0;
+        input.spawnOrb = (tick.buttons & REPLAY_SPAWN_ORB) != 0;
+        input.restart = (tick.buttons & REPLAY_RESTART) != 0;
+        input.closeMenu = (tick.buttons & REPLAY_CLOSE_MENU) != 0;
+        input.upgradeChoice = tick.upgradeChoice;
+        input.aim = (Vector2){ tick.aimX, tick.aimY };
+
+        SimStep(&input, tick.dt);
+
+        unsigned int checksum = SimChecksum();
+        if (checksum != tick.checksum) {
+            result->desyncTick = result->ticks;
+            result->expected = tick.checksum;
+            result->actual = checksum;
+            break;
+        }
+        result->ticks++;
+    }
+
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,35 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+// Grabacion y repeticion de partidas.
+//
+// Se guarda la semilla y, por cada tick, la entrada (teclas, punto de mira en
+// coordenadas de mundo, decisiones de menu), el dt y SimChecksum() despues del
+// tick. Como la simulacion solo depende de eso, ReplayRun() puede volver a
+// ejecutar la partida sin ventana a toda velocidad y comprobar en cada tick
+// que el estado coincide: sirve como carga repetible para medir y para
+// detectar desincronizaciones.
+#include "sim.h"
+#include <stdbool.h>
+
+#define REPLAY_VERSION 7        // 2: modo de juego en la cabecera; 3: movimiento escalado por dt; 4: aritmetica; 5: reinicio completo; 6: sin muertes dobles; 7: checksum de todo SimState
+
+typedef struct ReplayResult {
+    long ticks;                 // Ticks simulados
+    long desyncTick;            // Primer tick con checksum distinto, -1 si ninguno
+    unsigned int expected;      // Checksums de ese tick
+    unsigned int actual;
+} ReplayResult;
+
+// Se llama justo despues de SimInit(seed), antes del primer tick; el modo
+// (SimSetMode) tambien queda grabado
+bool ReplayRecordBegin(const char *fileName, unsigned int seed);
+void ReplayRecordTick(const SimInput *input, float dt, unsigned int checksum);
+void ReplayRecordEnd(void);
+
+// Reinicia la simulacion con la semilla y el modo grabados y repite todos los ticks;
+// se detiene en el primer tick desincronizado. Una grabacion hecha con otra
+// aritmetica (SimMathName) no se puede repetir: devuelve false
+bool ReplayRun(const char *fileName, ReplayResult *result);
+
+#endif
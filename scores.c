@@ -0,0 +1,660 @@
+#include "scores.h"
+#include "raylib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <time.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI               // Choca con Rectangle de raylib
+    #define NOUSER              // Choca con CloseWindow/ShowCursor de raylib
+    #include <windows.h>
+    #include <io.h>
+#else
+    #include <pthread.h>
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#define SCORE_RECORD_MAGIC 0x43455253u  // "SREC"
+#define SCORE_DB_VERSION 1
+#define SCORE_PATH_LENGTH 512
+#define SCORE_QUEUE_SIZE 16
+
+// Un registro del diario y de scores.db (48 bytes)
+typedef struct ScoreRecord {
+    unsigned int magic;
+    char name[SCORE_NAME_LENGTH];   // Rellenado con ceros
+    int kills;
+    unsigned int time;              // Segundos desde 1970; a igualdad de kills va antes el primero
+    unsigned int checksum;          // FNV-1a de todo lo anterior
+} ScoreRecord;
+
+// scores.db: cabecera, count registros de mayor a menor y count indices
+// (unsigned int) a esos registros ordenados por nombre
+typedef struct ScoreDbHeader {
+    char magic[4];                  // "SCDB"
+    unsigned int version;
+    unsigned int count;
+    unsigned int reserved;
+} ScoreDbHeader;
+
+typedef enum ScoreCommandType {
+    SCORE_SUBMIT = 0,
+    SCORE_REFRESH
+} ScoreCommandType;
+
+typedef struct ScoreCommand {
+    ScoreCommandType type;
+    char name[SCORE_NAME_LENGTH];
+    int kills;
+} ScoreCommand;
+
+static char journalPath[SCORE_PATH_LENGTH];
+static char dbPath[SCORE_PATH_LENGTH];
+static char tempPath[SCORE_PATH_LENGTH];
+static char lockPath[SCORE_PATH_LENGTH];
+static char legacyPath[SCORE_PATH_LENGTH];
+
+// Cola del hilo y copia que lee el juego (protegidas por queueLock)
+static ScoreCommand queue[SCORE_QUEUE_SIZE];
+static int queueHead = 0;
+static int queueCount = 0;
+static int busy = 0;                // Comandos en cola o en curso (atomico)
+static ScoreEntry topCache[SCORE_TOP_MAX];
+static int topCacheCount = 0;
+static int lastBest = -1;
+static int running = 0;
+static bool threaded = false;
+
+#if defined(_WIN32)
+    static HANDLE thread;
+    static HANDLE lockFile = INVALID_HANDLE_VALUE;
+    static SRWLOCK queueLock = SRWLOCK_INIT;
+    static CONDITION_VARIABLE queueCondition = CONDITION_VARIABLE_INIT;
+#else
+    static pthread_t thread;
+    static int lockFile = -1;
+    static pthread_mutex_t queueLock = PTHREAD_MUTEX_INITIALIZER;
+    static pthread_cond_t queueCondition = PTHREAD_COND_INITIALIZER;
+#endif
+
+// Solo las usa el hilo de puntuaciones (qsort no tiene contexto)
+static const ScoreRecord *sortRecords = NULL;
+
+//----------------------------------------------------------------------------------
+// Registros
+//----------------------------------------------------------------------------------
+static unsigned int RecordChecksum(const ScoreRecord *record)
+{
+    const unsigned char *bytes = (const unsigned char *)record;
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < offsetof(ScoreRecord, checksum); i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static ScoreRecord MakeRecord(const char *name, int kills, unsigned int when)
+{
+    ScoreRecord record;
+    memset(&record, 0, sizeof(record));
+    record.magic = SCORE_RECORD_MAGIC;
+    strncpy(record.name, name, SCORE_NAME_LENGTH - 1);
+    record.kills = kills;
+    record.time = when;
+    record.checksum = RecordChecksum(&record);
+    return record;
+}
+
+static bool RecordValid(const ScoreRecord *record)
+{
+    return record->magic == SCORE_RECORD_MAGIC && record->name[SCORE_NAME_LENGTH - 1] == '\0' &&
+           record->checksum == RecordChecksum(record);
+}
+
+// Nombre ascendente y, dentro de cada jugador, la mejor primero
+static int CompareByName(const void *a, const void *b)
+{
+    const ScoreRecord *ra = a, *rb = b;
+    int byName = strcmp(ra->name, rb->name);
+    if (byName != 0) return byName;
+    if (ra->kills != rb->kills) return (ra->kills > rb->kills)? -1 : 1;
+    return (ra->time < rb->time)? -1 : (ra->time > rb->time);
+}
+
+static int CompareByKills(const void *a, const void *b)
+{
+    const ScoreRecord *ra = a, *rb = b;
+    if (ra->kills != rb->kills) return (ra->kills > rb->kills)? -1 : 1;
+    if (ra->time != rb->time) return (ra->time < rb->time)? -1 : 1;
+    return strcmp(ra->name, rb->name);
+}
+
+static int CompareIndexByName(const void *a, const void *b)
+{
+    return strcmp(sortRecords[*(const unsigned int *)a].name, sortRecords[*(const unsigned int *)b].name);
+}
+
+// Deja una entrada por jugador (su mejor marca) ordenadas de mayor a menor;
+// devuelve cuantas quedan
+static int MergeBest(ScoreRecord *records, int count)
+{
+    if (count == 0) return 0;
+    qsort(records, count, sizeof(ScoreRecord), CompareByName);
+    int unique = 1;
+    for (int i = 1; i < count; i++) {
+        if (strcmp(records[i].name, records[unique - 1].name) != 0) records[unique++] = records[i];
+    }
+    qsort(records, unique, sizeof(ScoreRecord), CompareByKills);
+    return unique;
+}
+
+//----------------------------------------------------------------------------------
+// Archivos
+//----------------------------------------------------------------------------------
+// Bloqueo entre procesos sobre scores.lock (fcntl tambien funciona en NFS)
+static bool StoreLock(bool exclusive)
+{
+#if defined(_WIN32)
+    lockFile = CreateFileA(lockPath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                           NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (lockFile == INVALID_HANDLE_VALUE) return false;
+    OVERLAPPED overlapped = { 0 };
+    if (!LockFileEx(lockFile, exclusive? LOCKFILE_EXCLUSIVE_LOCK : 0, 0, 1, 0, &overlapped)) {
+        CloseHandle(lockFile);
+        lockFile = INVALID_HANDLE_VALUE;
+        return false;
+    }
+#else
+    lockFile = open(lockPath, O_RDWR | O_CREAT, 0666);
+    if (lockFile < 0) return false;
+    struct flock lock = { 0 };
+    lock.l_type = exclusive? F_WRLCK : F_RDLCK;
+    lock.l_whence = SEEK_SET;
+    while (fcntl(lockFile, F_SETLKW, &lock) != 0) {
+        if (errno != EINTR) {
+            close(lockFile);
+            lockFile = -1;
+            return false;
+        }
+    }
+#endif
+    return true;
+}
+
+static void StoreUnlock(void)
+{
+#if defined(_WIN32)
+    OVERLAPPED overlapped = { 0 };
+    UnlockFileEx(lockFile, 0, 1, 0, &overlapped);
+    CloseHandle(lockFile);
+    lockFile = INVALID_HANDLE_VALUE;
+#else
+    close(lockFile);    // Suelta el bloqueo
+    lockFile = -1;
+#endif
+}
+
+// Hasta el disco, no solo hasta la cache del sistema
+static bool SyncFile(FILE *file)
+{
+    if (fflush(file) != 0) return false;
+#if defined(_WIN32)
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+static bool FileExistsPlain(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return false;
+    fclose(file);
+    return true;
+}
+
+// Registros validos del diario (malloc); un final cortado o estropeado se ignora
+static int ReadJournal(ScoreRecord **records)
+{
+    *records = NULL;
+    FILE *file = fopen(journalPath, "rb");
+    if (file == NULL) return 0;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    int count = (int)(size/(long)sizeof(ScoreRecord));
+    if (count > 0) *records = malloc(count*sizeof(ScoreRecord));
+    int read = (count > 0)? (int)fread(*records, sizeof(ScoreRecord), count, file) : 0;
+    fclose(file);
+
+    int valid = 0;
+    for (int i = 0; i < read; i++) {
+        if (RecordValid(&(*records)[i])) (*records)[valid++] = (*records)[i];
+    }
+    return valid;
+}
+
+// Abre scores.db y comprueba la cabecera; NULL si no hay o no es valido
+static FILE *OpenDb(ScoreDbHeader *header)
+{
+    FILE *file = fopen(dbPath, "rb");
+    if (file == NULL) return NULL;
+    if (fread(header, sizeof(*header), 1, file) != 1 || memcmp(header->magic, "SCDB", 4) != 0 ||
+        header->version != SCORE_DB_VERSION) {
+        TraceLog(LOG_WARNING, "SCORES: %s no es valido, se ignora", dbPath);
+        fclose(file);
+        return NULL;
+    }
+    return file;
+}
+
+// Los count primeros registros validos de scores.db (malloc)
+static int ReadDb(ScoreRecord **records, int count)
+{
+    *records = NULL;
+    ScoreDbHeader header;
+    FILE *file = OpenDb(&header);
+    if (file == NULL) return 0;
+    if (count < 0 || count > (int)header.count) count = (int)header.count;
+    if (count > 0) *records = malloc(count*sizeof(ScoreRecord));
+    int read = (count > 0)? (int)fread(*records, sizeof(ScoreRecord), count, file) : 0;
+    fclose(file);
+
+    int valid = 0;
+    for (int i = 0; i < read; i++) {
+        if (RecordValid(&(*records)[i])) (*records)[valid++] = (*records)[i];
+    }
+    return valid;
+}
+
+// Con el bloqueo exclusivo: mezcla scores.db y el diario en un scores.db
+// nuevo (temporal + renombrar) y vacia el diario. Si se corta antes de
+// vaciarlo, el diario se vuelve a mezclar y da lo mismo
+static bool Compact(void)
+{
+    ScoreRecord *db, *journal;
+    int dbCount = ReadDb(&db, -1);
+    int journalCount = ReadJournal(&journal);
+    int count = dbCount + journalCount;
+    ScoreRecord *records = malloc((count > 0? count : 1)*sizeof(ScoreRecord));
+    if (dbCount > 0) memcpy(records, db, dbCount*sizeof(ScoreRecord));
+    if (journalCount > 0) memcpy(records + dbCount, journal, journalCount*sizeof(ScoreRecord));
+    free(db);
+    free(journal);
+    count = MergeBest(records, count);
+
+    unsigned int *index = malloc((count > 0? count : 1)*sizeof(unsigned int));
+    for (int i = 0; i < count; i++) index[i] = (unsigned int)i;
+    sortRecords = records;
+    qsort(index, count, sizeof(unsigned int), CompareIndexByName);
+
+    ScoreDbHeader header = { 0 };
+    memcpy(header.magic, "SCDB", 4);
+    header.version = SCORE_DB_VERSION;
+    header.count = (unsigned int)count;
+
+    bool ok = false;
+    FILE *file = fopen(tempPath, "wb");
+    if (file != NULL) {
+        ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             (int)fwrite(records, sizeof(ScoreRecord), count, file) == count &&
+             (int)fwrite(index, sizeof(unsigned int), count, file) == count;
+        ok = SyncFile(file) && ok;
+        ok = (fclose(file) == 0) && ok;
+    }
+    free(records);
+    free(index);
+
+#if defined(_WIN32)
+    if (ok) ok = MoveFileExA(tempPath, dbPath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    if (ok) ok = rename(tempPath, dbPath) == 0;
+#endif
+    if (!ok) {
+        TraceLog(LOG_WARNING, "SCORES: No se pudo compactar en %s", dbPath);
+        remove(tempPath);
+        return false;
+    }
+
+    file = fopen(journalPath, "wb");
+    if (file != NULL) fclose(file);
+    TraceLog(LOG_INFO, "SCORES: Compactado: %d jugadores", count);
+    return true;
+}
+
+// Con el bloqueo exclusivo: anade al diario y lo deja en disco; devuelve
+// cuantos registros tiene despues, -1 si fallo
+static int AppendRecords(const ScoreRecord *records, int count)
+{
+    FILE *file = fopen(journalPath, "ab");
+    if (file == NULL) return -1;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    long whole = size - size%(long)sizeof(ScoreRecord);
+    if (whole != size) {
+        // Registro a medias de un cierre inesperado: se recorta para no
+        // desalinear los siguientes
+#if defined(_WIN32)
+        _chsize_s(_fileno(file), whole);
+#else
+        if (ftruncate(fileno(file), whole) != 0) whole = size;
+#endif
+        fseek(file, 0, SEEK_END);
+    }
+    bool ok = (int)fwrite(records, sizeof(ScoreRecord), count, file) == count;
+    ok = SyncFile(file) && ok;
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) return -1;
+    return (int)(whole/(long)sizeof(ScoreRecord)) + count;
+}
+
+static bool WriteScores(const ScoreRecord *records, int count)
+{
+    if (!StoreLock(true)) {
+        TraceLog(LOG_WARNING, "SCORES: No se pudo bloquear %s", lockPath);
+        return false;
+    }
+    int journalCount = AppendRecords(records, count);
+    if (journalCount < 0) TraceLog(LOG_WARNING, "SCORES: No se pudo escribir %s", journalPath);
+    else if (journalCount >= SCORE_COMPACT_RECORDS) Compact();
+    StoreUnlock();
+    return journalCount >= 0;
+}
+
+// Top K: los K primeros de scores.db mas el diario. Un jugador que no esta
+// entre esos K solo puede subir por un registro del diario, asi que basta
+static int ReadTop(ScoreEntry *entries, int max)
+{
+    if (!StoreLock(false)) return 0;
+    ScoreRecord *db, *journal;
+    int dbCount = ReadDb(&db, max);
+    int journalCount = ReadJournal(&journal);
+    StoreUnlock();
+
+    int count = dbCount + journalCount;
+    ScoreRecord *records = malloc((count > 0? count : 1)*sizeof(ScoreRecord));
+    if (dbCount > 0) memcpy(records, db, dbCount*sizeof(ScoreRecord));
+    if (journalCount > 0) memcpy(records + dbCount, journal, journalCount*sizeof(ScoreRecord));
+    free(db);
+    free(journal);
+    count = MergeBest(records, count);
+
+    if (count > max) count = max;
+    for (int i = 0; i < count; i++) {
+        memcpy(entries[i].name, records[i].name, SCORE_NAME_LENGTH);
+        entries[i].kills = records[i].kills;
+    }
+    free(records);
+    return count;
+}
+
+// Mejor marca de un jugador: busqueda binaria en el indice de scores.db
+// (log2(n) lecturas) y el diario; -1 si no tiene ninguna
+static int ReadBest(const char *name)
+{
+    if (!StoreLock(false)) return -1;
+    int best = -1;
+
+    ScoreDbHeader header;
+    FILE *file = OpenDb(&header);
+    if (file != NULL) {
+        long indexStart = (long)sizeof(header) + (long)header.count*(long)sizeof(ScoreRecord);
+        int low = 0, high = (int)header.count - 1;
+        while (low <= high) {
+            int middle = (low + high)/2;
+            unsigned int position;
+            ScoreRecord record;
+            fseek(file, indexStart + middle*(long)sizeof(unsigned int), SEEK_SET);
+            if (fread(&position, sizeof(position), 1, file) != 1 || position >= header.count) break;
+            fseek(file, (long)sizeof(header) + (long)position*(long)sizeof(ScoreRecord), SEEK_SET);
+            if (fread(&record, sizeof(record), 1, file) != 1 || !RecordValid(&record)) break;
+
+            int order = strcmp(name, record.name);
+            if (order == 0) { best = record.kills; break; }
+            if (order < 0) high = middle - 1;
+            else low = middle + 1;
+        }
+        fclose(file);
+    }
+
+    ScoreRecord *journal;
+    int journalCount = ReadJournal(&journal);
+    StoreUnlock();
+    for (int i = 0; i < journalCount; i++) {
+        if (journal[i].kills > best && strcmp(journal[i].name, name) == 0) best = journal[i].kills;
+    }
+    free(journal);
+    return best;
+}
+
+// scores.dat de versiones anteriores: ScoreEntry tal cual, sin cabecera
+static void ImportLegacy(void)
+{
+    if (FileExistsPlain(dbPath) || FileExistsPlain(journalPath)) return;
+    FILE *file = fopen(legacyPath, "rb");
+    if (file == NULL) return;
+
+    ScoreRecord records[SCORE_TOP_MAX];
+    ScoreEntry entry;
+    int count = 0;
+    unsigned int now = (unsigned int)time(NULL);
+    while (count < SCORE_TOP_MAX && fread(&entry, sizeof(entry), 1, file) == 1) {
+        entry.name[SCORE_NAME_LENGTH - 1] = '\0';
+        records[count++] = MakeRecord(entry.name, entry.kills, now);
+    }
+    fclose(file);
+    if (count > 0 && WriteScores(records, count)) {
+        TraceLog(LOG_INFO, "SCORES: Importadas %d puntuaciones de %s", count, legacyPath);
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Hilo de puntuaciones
+//----------------------------------------------------------------------------------
+static void QueueLock(void)
+{
+#if defined(_WIN32)
+    AcquireSRWLockExclusive(&queueLock);
+#else
+    pthread_mutex_lock(&queueLock);
+#endif
+}
+
+static void QueueUnlock(void)
+{
+#if defined(_WIN32)
+    ReleaseSRWLockExclusive(&queueLock);
+#else
+    pthread_mutex_unlock(&queueLock);
+#endif
+}
+
+static void QueueWait(void)
+{
+#if defined(_WIN32)
+    SleepConditionVariableSRW(&queueCondition, &queueLock, INFINITE, 0);
+#else
+    pthread_cond_wait(&queueCondition, &queueLock);
+#endif
+}
+
+static void QueueSignal(void)
+{
+#if defined(_WIN32)
+    WakeConditionVariable(&queueCondition);
+#else
+    pthread_cond_signal(&queueCondition);
+#endif
+}
+
+static void RunCommand(const ScoreCommand *command)
+{
+    int best = -2;      // Sin cambios
+    if (command->type == SCORE_SUBMIT) {
+        ScoreRecord record = MakeRecord(command->name, command->kills, (unsigned int)time(NULL));
+        WriteScores(&record, 1);
+        best = ReadBest(command->name);
+    }
+    ScoreEntry top[SCORE_TOP_MAX];
+    int count = ReadTop(top, SCORE_TOP_MAX);
+
+    // Solo se bloquea la cola para copiar, nunca durante el disco
+    QueueLock();
+    memcpy(topCache, top, count*sizeof(ScoreEntry));
+    topCacheCount = count;
+    if (best != -2) lastBest = best;
+    QueueUnlock();
+    __atomic_fetch_sub(&busy, 1, __ATOMIC_RELEASE);
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI ScoresMain(LPVOID arg)
+#else
+static void *ScoresMain(void *arg)
+#endif
+{
+    (void)arg;
+    ImportLegacy();
+    QueueLock();
+    for (;;) {
+        // Lo pendiente se escribe aunque se este cerrando
+        while (queueCount == 0 && running) QueueWait();
+        if (queueCount == 0) break;
+        ScoreCommand command = queue[queueHead];
+        queueHead = (queueHead + 1)%SCORE_QUEUE_SIZE;
+        queueCount--;
+        QueueUnlock();
+        RunCommand(&command);
+        QueueLock();
+    }
+    QueueUnlock();
+#if defined(_WIN32)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+static void Enqueue(const ScoreCommand *command)
+{
+    if (!threaded) {
+        // Sin hilo se hace aqui mismo
+        __atomic_fetch_add(&busy, 1, __ATOMIC_RELAXED);
+        RunCommand(command);
+        return;
+    }
+    QueueLock();
+    bool queued = false;
+    if (command->type == SCORE_REFRESH) {
+        // Si ya hay uno pendiente da lo mismo
+        for (int i = 0; i < queueCount && !queued; i++) {
+            queued = queue[(queueHead + i)%SCORE_QUEUE_SIZE].type == SCORE_REFRESH;
+        }
+        if (queued) {
+            QueueUnlock();
+            return;
+        }
+    }
+    if (queueCount < SCORE_QUEUE_SIZE) {
+        queue[(queueHead + queueCount)%SCORE_QUEUE_SIZE] = *command;
+        queueCount++;
+        queued = true;
+        __atomic_fetch_add(&busy, 1, __ATOMIC_RELAXED);
+        QueueSignal();
+    }
+    QueueUnlock();
+    if (!queued && command->type == SCORE_SUBMIT) {
+        TraceLog(LOG_WARNING, "SCORES: Cola llena, se pierde la puntuacion de %s", command->name);
+    }
+}
+
+//----------------------------------------------------------------------------------
+// API
+//----------------------------------------------------------------------------------
+bool ScoresInit(const char *directory)
+{
+    if (directory == NULL || directory[0] == '\0') directory = ".";
+    snprintf(journalPath, sizeof(journalPath), "%s/scores.log", directory);
+    snprintf(dbPath, sizeof(dbPath), "%s/scores.db", directory);
+    snprintf(tempPath, sizeof(tempPath), "%s/scores.db.tmp", directory);
+    snprintf(lockPath, sizeof(lockPath), "%s/scores.lock", directory);
+    snprintf(legacyPath, sizeof(legacyPath), "%s/scores.dat", directory);
+
+    running = 1;
+#if defined(_WIN32)
+    thread = CreateThread(NULL, 0, ScoresMain, NULL, 0, NULL);
+    threaded = (thread != NULL);
+#else
+    threaded = (pthread_create(&thread, NULL, ScoresMain, NULL) == 0);
+#endif
+    if (!threaded) {
+        TraceLog(LOG_WARNING, "SCORES: Sin hilo, se escribira desde el juego");
+        ImportLegacy();
+    }
+    ScoreRefresh();
+    TraceLog(LOG_INFO, "SCORES: Puntuaciones en %s", directory);
+    return threaded;
+}
+
+void ScoresShutdown(void)
+{
+    if (!threaded) return;
+    QueueLock();
+    running = 0;
+    QueueSignal();
+    QueueUnlock();
+#if defined(_WIN32)
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+    threaded = false;
+}
+
+void ScoreSubmit(const char *name, int kills)
+{
+    ScoreCommand command = { 0 };
+    command.type = SCORE_SUBMIT;
+    strncpy(command.name, name, SCORE_NAME_LENGTH - 1);
+    command.kills = kills;
+    QueueLock();
+    lastBest = -1;
+    QueueUnlock();
+    Enqueue(&command);
+}
+
+void ScoreRefresh(void)
+{
+    ScoreCommand command = { 0 };
+    command.type = SCORE_REFRESH;
+    Enqueue(&command);
+}
+
+bool ScoresBusy(void)
+{
+    return __atomic_load_n(&busy, __ATOMIC_ACQUIRE) > 0;
+}
+
+int ScoreTop(ScoreEntry *entries, int max)
+{
+    QueueLock();
+    int count = (max < topCacheCount)? max : topCacheCount;
+    memcpy(entries, topCache, count*sizeof(ScoreEntry));
+    QueueUnlock();
+    return count;
+}
+
+int ScoreLastPlayerBest(void)
+{
+    QueueLock();
+    int best = lastBest;
+    QueueUnlock();
+    return best;
+}
@@ -0,0 +1,53 @@
+#ifndef SCORES_H
+#define SCORES_H
+
+// Puntuaciones compartidas entre varias instancias del juego (por ejemplo
+// varios kioscos sobre la misma carpeta de red).
+//
+// En disco hay dos archivos en la carpeta de puntuaciones:
+//  - scores.log: diario de solo anadir. Cada partida es un registro de
+//    tamano fijo con su checksum; uno cortado por un cierre a medias se
+//    descarta (y se recorta antes de la siguiente escritura).
+//  - scores.db: la mejor puntuacion de cada jugador, ordenada de mayor a
+//    menor, mas un indice por nombre. Se rehace (compactacion) cuando el
+//    diario pasa de SCORE_COMPACT_RECORDS registros: se escribe en un
+//    temporal y se renombra encima, asi que siempre hay uno completo.
+//
+// El top K lee los K primeros registros de scores.db y el diario (que
+// nunca es largo), no todo el historial; la mejor marca de un jugador es
+// una busqueda binaria en el indice. Todo pasa con scores.lock bloqueado
+// (compartido para leer, exclusivo para escribir), de modo que varios
+// procesos pueden escribir a la vez.
+//
+// Las lecturas y escrituras las hace un hilo propio: el juego encola
+// (ScoreSubmit, ScoreRefresh) y dibuja la ultima copia (ScoreTop) sin
+// esperar nunca al disco.
+#include <stdbool.h>
+
+#define SCORE_NAME_LENGTH 32
+#define SCORE_TOP_MAX 32            // K maximo de la copia que ve el juego
+#define SCORE_COMPACT_RECORDS 64    // Registros del diario que disparan la compactacion
+
+typedef struct ScoreEntry {
+    char name[SCORE_NAME_LENGTH];
+    int kills;
+} ScoreEntry;
+
+// directory: carpeta de los archivos ("." si es NULL). Si no hay nada alli
+// pero existe el antiguo scores.dat, se importa
+bool ScoresInit(const char *directory);
+// Espera a que se escriba lo pendiente
+void ScoresShutdown(void);
+
+// Guarda la partida y refresca la copia; no bloquea
+void ScoreSubmit(const char *name, int kills);
+// Vuelve a leer el top (otras instancias pueden haber escrito); no bloquea
+void ScoreRefresh(void);
+bool ScoresBusy(void);              // Hay trabajo en cola o en curso
+
+// Ultima copia del top, de mayor a menor; devuelve cuantos hay
+int ScoreTop(ScoreEntry *entries, int max);
+// Mejor marca del ultimo jugador enviado con ScoreSubmit, -1 si aun no se sabe
+int ScoreLastPlayerBest(void);
+
+#endif
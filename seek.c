@@ -0,0 +1,167 @@
+#include "seek.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define SEEK_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define SEEK_WIDTH 4
+#else
+    #define SEEK_WIDTH 1
+#endif
+
+// Un enemigo: sigue el campo o, si es (0, 0), va derecho al objetivo con el
+// mismo calculo que Vector2Normalize + Vector2Scale de raymath
+static inline bool SeekOne(float *x, float *y, float flowX, float flowY, float speed, float radius,
+                           Vector2 target, float targetRadius)
+{
+    float dx = target.x - *x;
+    float dy = target.y - *y;
+    float distance = sqrtf(dx*dx + dy*dy);
+
+    if (flowX != 0.0f || flowY != 0.0f) {
+        *x += flowX*speed;
+        *y += flowY*speed;
+    } else if (distance > 0.0f) {
+        float inv = 1.0f/distance;
+        *x += (dx*inv)*speed;
+        *y += (dy*inv)*speed;
+    }
+
+    float ndx = target.x - *x;
+    float ndy = target.y - *y;
+    float reach = targetRadius + radius;
+    return (ndx*ndx + ndy*ndy <= reach*reach) && (distance <= radius + targetRadius);
+}
+
+int SeekKernel(float *x, float *y, const float *flowX, const float *flowY,
+               const float *speed, float scale, const float *radius, const unsigned char *enabled, int count,
+               Vector2 target, float targetRadius, int *contacts)
+{
+    int contactCount = 0;
+    int i = 0;
+
+#if SEEK_WIDTH == 8
+    const __m256 tx = _mm256_set1_ps(target.x);
+    const __m256 ty = _mm256_set1_ps(target.y);
+    const __m256 tr = _mm256_set1_ps(targetRadius);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 step = _mm256_set1_ps(scale);
+
+    for (; i + 8 <= count; i += 8) {
+        __m128i alive8 = _mm_loadl_epi64((const __m128i *)(enabled + i));
+        __m256 alive = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_cvtepu8_epi32(alive8), _mm256_setzero_si256()));
+        if (_mm256_movemask_ps(alive) == 0) continue;
+
+        __m256 px = _mm256_loadu_ps(x + i);
+        __m256 py = _mm256_loadu_ps(y + i);
+        __m256 sp = _mm256_mul_ps(_mm256_loadu_ps(speed + i), step);
+        __m256 rad = _mm256_loadu_ps(radius + i);
+
+        __m256 dx = _mm256_sub_ps(tx, px);
+        __m256 dy = _mm256_sub_ps(ty, py);
+        __m256 distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+        __m256 moving = _mm256_and_ps(alive, _mm256_cmp_ps(distance, zero, _CMP_GT_OQ));
+        __m256 inv = _mm256_div_ps(one, distance);
+
+        // Donde el campo da una direccion se usa esa en lugar de la recta
+        __m256 fx = _mm256_loadu_ps(flowX + i);
+        __m256 fy = _mm256_loadu_ps(flowY + i);
+        __m256 flow = _mm256_or_ps(_mm256_cmp_ps(fx, zero, _CMP_NEQ_UQ), _mm256_cmp_ps(fy, zero, _CMP_NEQ_UQ));
+        __m256 sx = _mm256_blendv_ps(_mm256_mul_ps(dx, inv), fx, flow);
+        __m256 sy = _mm256_blendv_ps(_mm256_mul_ps(dy, inv), fy, flow);
+        moving = _mm256_or_ps(moving, _mm256_and_ps(alive, flow));
+
+        __m256 nx = _mm256_add_ps(px, _mm256_mul_ps(sx, sp));
+        __m256 ny = _mm256_add_ps(py, _mm256_mul_ps(sy, sp));
+        px = _mm256_blendv_ps(px, nx, moving);
+        py = _mm256_blendv_ps(py, ny, moving);
+        _mm256_storeu_ps(x + i, px);
+        _mm256_storeu_ps(y + i, py);
+
+        __m256 ndx = _mm256_sub_ps(tx, px);
+        __m256 ndy = _mm256_sub_ps(ty, py);
+        __m256 reach = _mm256_add_ps(tr, rad);
+        __m256 touching = _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(ndx, ndx), _mm256_mul_ps(ndy, ndy)), _mm256_mul_ps(reach, reach), _CMP_LE_OQ);
+        touching = _mm256_and_ps(touching, _mm256_cmp_ps(distance, _mm256_add_ps(rad, tr), _CMP_LE_OQ));
+        int mask = _mm256_movemask_ps(_mm256_and_ps(touching, alive));
+        for (int lane = 0; lane < 8; lane++) {
+            if (mask & (1 << lane)) contacts[contactCount++] = i + lane;
+        }
+    }
+#elif SEEK_WIDTH == 4
+    const __m128 tx = _mm_set1_ps(target.x);
+    const __m128 ty = _mm_set1_ps(target.y);
+    const __m128 tr = _mm_set1_ps(targetRadius);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 step = _mm_set1_ps(scale);
+
+    for (; i + 4 <= count; i += 4) {
+        int packed;
+        memcpy(&packed, enabled + i, sizeof(packed));
+        if (packed == 0) continue;
+        __m128i bytes = _mm_cvtsi32_si128(packed);
+        __m128i words = _mm_unpacklo_epi8(bytes, _mm_setzero_si128());
+        __m128i dwords = _mm_unpacklo_epi16(words, _mm_setzero_si128());
+        __m128 alive = _mm_castsi128_ps(_mm_cmpgt_epi32(dwords, _mm_setzero_si128()));
+
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 py = _mm_loadu_ps(y + i);
+        __m128 sp = _mm_mul_ps(_mm_loadu_ps(speed + i), step);
+        __m128 rad = _mm_loadu_ps(radius + i);
+
+        __m128 dx = _mm_sub_ps(tx, px);
+        __m128 dy = _mm_sub_ps(ty, py);
+        __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+        __m128 moving = _mm_and_ps(alive, _mm_cmpgt_ps(distance, zero));
+        __m128 inv = _mm_div_ps(one, distance);
+
+        // Donde el campo da una direccion se usa esa en lugar de la recta
+        __m128 fx = _mm_loadu_ps(flowX + i);
+        __m128 fy = _mm_loadu_ps(flowY + i);
+        __m128 flow = _mm_or_ps(_mm_cmpneq_ps(fx, zero), _mm_cmpneq_ps(fy, zero));
+        __m128 sx = _mm_or_ps(_mm_and_ps(flow, fx), _mm_andnot_ps(flow, _mm_mul_ps(dx, inv)));
+        __m128 sy = _mm_or_ps(_mm_and_ps(flow, fy), _mm_andnot_ps(flow, _mm_mul_ps(dy, inv)));
+        moving = _mm_or_ps(moving, _mm_and_ps(alive, flow));
+
+        __m128 nx = _mm_add_ps(px, _mm_mul_ps(sx, sp));
+        __m128 ny = _mm_add_ps(py, _mm_mul_ps(sy, sp));
+        px = _mm_or_ps(_mm_and_ps(moving, nx), _mm_andnot_ps(moving, px));
+        py = _mm_or_ps(_mm_and_ps(moving, ny), _mm_andnot_ps(moving, py));
+        _mm_storeu_ps(x + i, px);
+        _mm_storeu_ps(y + i, py);
+
+        __m128 ndx = _mm_sub_ps(tx, px);
+        __m128 ndy = _mm_sub_ps(ty, py);
+        __m128 reach = _mm_add_ps(tr, rad);
+        __m128 touching = _mm_cmple_ps(_mm_add_ps(_mm_mul_ps(ndx, ndx), _mm_mul_ps(ndy, ndy)), _mm_mul_ps(reach, reach));
+        touching = _mm_and_ps(touching, _mm_cmple_ps(distance, _mm_add_ps(rad, tr)));
+        int mask = _mm_movemask_ps(_mm_and_ps(touching, alive));
+        for (int lane = 0; lane < 4; lane++) {
+            if (mask & (1 << lane)) contacts[contactCount++] = i + lane;
+        }
+    }
+#endif
+
+    // Resto (o todo, sin SIMD)
+    for (; i < count; i++) {
+        if (!enabled[i]) continue;
+        if (SeekOne(&x[i], &y[i], flowX[i], flowY[i], speed[i]*scale, radius[i], target, targetRadius)) contacts[contactCount++] = i;
+    }
+    return contactCount;
+}
+
+const char *SeekKernelName(void)
+{
+#if SEEK_WIDTH == 8
+    return "avx2";
+#elif SEEK_WIDTH == 4
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,20 @@
+#ifndef SEEK_H
+#define SEEK_H
+
+// Kernel de persecucion: mueve cada enemigo vivo speed*scale px en la direccion del
+// campo de flujo (flowX/flowY, ver FlowFieldSample), o derecho al objetivo
+// donde esa direccion es (0, 0), y marca los que tocan al jugador, en una
+// sola pasada sobre los arreglos.
+// Usa AVX2 u SSE2 si el compilador los habilita y un bucle escalar si no;
+// todas las variantes hacen las mismas operaciones en el mismo orden.
+#include "raylib.h"
+
+// Devuelve cuantos indices se escribieron en contacts (en orden ascendente)
+int SeekKernel(float *x, float *y, const float *flowX, const float *flowY,
+               const float *speed, float scale, const float *radius, const unsigned char *enabled, int count,
+               Vector2 target, float targetRadius, int *contacts);
+
+// Nombre de la variante compilada ("avx2", "sse2" o "scalar")
+const char *SeekKernelName(void);
+
+#endif
@@ -0,0 +1,151 @@
+#include "separation.h"
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define SEPARATION_SSE2 1
+#else
+    #define SEPARATION_SSE2 0
+#endif
+
+#define SEPARATION_EPSILON 1e-6f    // Distancia^2 por debajo de la cual estan uno encima de otro
+
+// Empuje sobre el enemigo del slot k por el del slot m, sumado al carril
+// que le toca. La version SSE2 hace exactamente estas operaciones en cada
+// carril: con y sin SIMD la simulacion da el mismo resultado bit a bit.
+// (Los carriles sin vecino suman ±0, y una suma que empieza en +0 nunca
+// llega a -0, asi que sumar o no esos ceros da el mismo valor.)
+static inline void PairPush(const float *sortedX, const float *sortedY, const float *sortedRadius,
+                            int k, int m, float x, float y, float radius, float *laneX, float *laneY)
+{
+    float dx = x - sortedX[m];
+    float dy = y - sortedY[m];
+    float minDistance = radius + sortedRadius[m];
+    float distance2 = dx*dx + dy*dy;
+    float scale = 0.0f;
+
+    // Los que no se tocan suman 0: sin salto que predecir en una multitud
+    if (distance2 > SEPARATION_EPSILON) {
+        float distance = sqrtf(distance2);
+        float overlap = minDistance - distance;
+        overlap = (overlap > 0.0f)? overlap : 0.0f;
+        scale = 0.5f*overlap/distance;
+    }
+    *laneX += dx*scale;
+    *laneY += dy*scale;
+
+    // Uno encima de otro: se separan en x segun el orden en la rejilla
+    if (distance2 <= SEPARATION_EPSILON && m != k) *laneX += (k < m)? -0.5f*minDistance : 0.5f*minDistance;
+}
+
+void SeparationGather(const Enemies *enemies, const SpatialGrid *grid, int begin, int end,
+                      float *sortedX, float *sortedY, float *sortedRadius)
+{
+    for (int k = begin; k < end; k++) {
+        int i = grid->cellItems[k];
+        sortedX[k] = enemies->x[i];
+        sortedY[k] = enemies->y[i];
+        sortedRadius[k] = enemies->radius[i];
+    }
+}
+
+void SeparationKernel(const SpatialGrid *grid, const float *sortedX, const float *sortedY,
+                      const float *sortedRadius, int begin, int end, float maxStep, float *pushX, float *pushY)
+{
+    for (int k = begin; k < end; k++) {
+        float x = sortedX[k];
+        float y = sortedY[k];
+        float radius = sortedRadius[k];
+        // Alcance maximo de un solape: ningun enemigo es mayor que ENEMY_RADIUS
+        float reach = radius + ENEMY_RADIUS;
+        int minX = GridCoord(x - reach);
+        int maxX = GridCoord(x + reach);
+        int minY = GridCoord(y - reach);
+        int maxY = GridCoord(y + reach);
+        // El cupo se reparte por igual entre las celdas (1, 2 o 4): si se
+        // gastara en orden, en una multitud los vecinos de las primeras
+        // celdas empujarian siempre hacia el mismo lado
+        int quota = SEPARATION_MAX_CANDIDATES/((maxX - minX + 1)*(maxY - minY + 1));
+
+        // Cuatro sumas parciales: el vecino start + 4*g + lane de cada celda va al carril lane
+        float laneX[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        float laneY[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+#if SEPARATION_SSE2
+        const __m128 vx = _mm_set1_ps(x);
+        const __m128 vy = _mm_set1_ps(y);
+        const __m128 vr = _mm_set1_ps(radius);
+        const __m128 epsilon = _mm_set1_ps(SEPARATION_EPSILON);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128i laneIndex = _mm_set_epi32(3, 2, 1, 0);
+        __m128 accX = zero;
+        __m128 accY = zero;
+#endif
+
+        for (int cy = minY; cy <= maxY; cy++) {
+            for (int cx = minX; cx <= maxX; cx++) {
+                int cell = cy*GRID_DIM + cx;
+                int start = grid->cellStart[cell];
+                int stop = grid->cellStart[cell + 1];
+                if (stop - start > quota) stop = start + quota;
+                int m = start;
+
+#if SEPARATION_SSE2
+                // Siempre el cupo entero, aunque la celda tenga menos: lo que
+                // pasa de stop (la celda siguiente o el relleno) suma 0, que no
+                // cambia la suma, y el bucle tiene siempre las mismas vueltas.
+                // Con vueltas variables los saltos mal predichos costaban mas
+                // que los grupos de sobra.
+                for (; m < start + quota; m += 4) {
+                    __m128 valid = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_set1_epi32(stop - m), laneIndex));
+                    __m128 dx = _mm_sub_ps(vx, _mm_loadu_ps(sortedX + m));
+                    __m128 dy = _mm_sub_ps(vy, _mm_loadu_ps(sortedY + m));
+                    __m128 minDistance = _mm_add_ps(vr, _mm_loadu_ps(sortedRadius + m));
+                    __m128 distance2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+                    __m128 apart = _mm_cmpgt_ps(distance2, epsilon);
+                    __m128 distance = _mm_sqrt_ps(_mm_max_ps(distance2, epsilon));
+                    __m128 overlap = _mm_max_ps(_mm_sub_ps(minDistance, distance), zero);
+                    __m128 scale = _mm_and_ps(_mm_and_ps(apart, valid), _mm_div_ps(_mm_mul_ps(half, overlap), distance));
+                    accX = _mm_add_ps(accX, _mm_mul_ps(dx, scale));
+                    accY = _mm_add_ps(accY, _mm_mul_ps(dy, scale));
+
+                    // Sin contarse a si mismo (siempre esta en su celda): si no, todos
+                    // los enemigos pasarian una vez por el camino lento
+                    __m128 self = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_set1_epi32(k - m), laneIndex));
+                    int together = _mm_movemask_ps(_mm_andnot_ps(_mm_or_ps(apart, self), valid));
+                    if (together != 0) {
+                        _mm_storeu_ps(laneX, accX);
+                        for (int lane = 0; lane < 4; lane++) {
+                            if (!(together & (1 << lane)) || m + lane == k) continue;
+                            float minTogether = radius + sortedRadius[m + lane];
+                            laneX[lane] += (k < m + lane)? -0.5f*minTogether : 0.5f*minTogether;
+                        }
+                        accX = _mm_loadu_ps(laneX);
+                    }
+                }
+#else
+                for (; m < stop; m++) {
+                    int lane = (m - start) & 3;
+                    PairPush(sortedX, sortedY, sortedRadius, k, m, x, y, radius, &laneX[lane], &laneY[lane]);
+                }
+#endif
+            }
+        }
+
+#if SEPARATION_SSE2
+        _mm_storeu_ps(laneX, accX);
+        _mm_storeu_ps(laneY, accY);
+#endif
+        float px = (laneX[0] + laneX[1]) + (laneX[2] + laneX[3]);
+        float py = (laneY[0] + laneY[1]) + (laneY[2] + laneY[3]);
+
+        float length2 = px*px + py*py;
+        if (length2 > maxStep*maxStep) {
+            float scale = maxStep/sqrtf(length2);
+            px *= scale;
+            py *= scale;
+        }
+        pushX[k] = px;
+        pushY[k] = py;
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef SEPARATION_H
+#define SEPARATION_H
+
+// Separacion entre enemigos: cada tick, cada enemigo que se solapa con sus
+// vecinos recibe un empuje que deshace la mitad del solape de cada pareja
+// (la otra mitad se la lleva el vecino).
+//
+// Trabaja en el orden de la rejilla de colisiones: SeparationGather copia
+// posicion y radio de cellItems[k] a sorted*[k], asi los enemigos de una
+// celda quedan contiguos y los vecinos se recorren sin saltos en memoria.
+// Se miran solo las celdas que toca cada enemigo y como mucho
+// SEPARATION_MAX_CANDIDATES vecinos: el coste es lineal aunque se amontonen.
+//
+// Las dos funciones trabajan sobre el rango [begin, end) de la rejilla y
+// solo escriben ahi: se pueden repartir en trozos. Los empujes (por slot de
+// la rejilla) se aplican despues, todos a la vez. sorted* necesitan
+// SEPARATION_PADDING elementos mas que la rejilla (se lee el cupo entero
+// de cada celda, aunque tenga menos).
+// maxStep es el empuje maximo de este tick: SEPARATION_MAX_STEP escalado
+// por la duracion del tick, igual que las velocidades.
+#include "sim.h"
+#include "grid.h"
+
+#define SEPARATION_MAX_STEP 2.0f        // Empuje maximo por tick de referencia (px)
+#define SEPARATION_MAX_CANDIDATES 32    // Vecinos mirados por enemigo
+#define SEPARATION_PADDING SEPARATION_MAX_CANDIDATES
+
+void SeparationGather(const Enemies *enemies, const SpatialGrid *grid, int begin, int end,
+                      float *sortedX, float *sortedY, float *sortedRadius);
+void SeparationKernel(const SpatialGrid *grid, const float *sortedX, const float *sortedY,
+                      const float *sortedRadius, int begin, int end, float maxStep, float *pushX, float *pushY);
+
+#endif
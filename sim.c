@@ -0,0 +1,1545 @@
+#include "sim.h"
+#include "grid.h"
+#include "seek.h"
+#include "separation.h"
+#include "flowfield.h"
+#include "profiler.h"
+#include "jobs.h"
+#include "arena.h"
+#include "fixed.h"
+#define RAYMATH_STATIC_INLINE
+#include "raymath.h"
+#include <stddef.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Variables
+//----------------------------------------------------------------------------------
+SimMode simMode = SIM_MODE_NORMAL;
+int maxOrbs = MAX_ORBS;
+int maxEnemies = MAX_ENEMIES;
+int maxProjectiles = MAX_PROJECTILES;
+bool crowdSeparation = true;
+SimState sim = { .randomState = 0x2545F491u };
+Orb *orbs = NULL;
+IndexPool orbPool = { 0 };
+Enemies enemies = { 0 };
+Projectile *projectiles = NULL;
+IndexPool projectilePool = { 0 };
+static float tickScale = 1.0f;  // dt*SIM_REFERENCE_RATE del tick en curso
+
+// Rejilla de enemigos, reconstruida una vez por tick
+SpatialGrid enemyGrid = { 0 };
+
+// Obstaculos fijos de la arena, alineados a la rejilla (ver flowfield.h).
+// El centro queda libre: ahi aparece el jugador.
+const Rectangle obstacles[] = {
+    { -448, -448, 128, 128 }, { 320, -448, 128, 128 },     // Pilares alrededor del centro
+    { -448, 320, 128, 128 }, { 320, 320, 128, 128 },
+    { -1280, -640, 64, 640 }, { 1216, 0, 64, 640 },        // Muros
+    { -640, -1280, 640, 64 }, { 0, 1216, 640, 64 },
+    { -2048, -2048, 512, 64 }, { -2048, -1984, 64, 448 },  // Esquinas en L
+    { 1536, 1984, 512, 64 }, { 1984, 1536, 64, 448 },
+    { 1536, -1920, 256, 256 }, { -1792, 1664, 256, 256 }   // Bloques
+};
+const int obstacleCount = sizeof(obstacles)/sizeof(obstacles[0]);
+
+// Campo de flujo hacia el jugador
+#define FLOW_BUDGET 2048        // Celdas por tick: se rehace en ~7 ticks
+FlowField flowField = { 0 };
+
+// Impacto pendiente: el proyectil del slot toca al enemigo en el instante
+// time (0 al empezar el tick, 1 al acabar)
+typedef struct ProjectileHit {
+    float time;
+    int slot;
+    int enemy;
+} ProjectileHit;
+
+// Memoria de la partida: entidades y arreglos auxiliares
+static Arena levelArena = { 0 };
+
+// Auxiliares: crecen junto con las entidades (ver GrowEnemies)
+#define ORB_CHUNK 64
+#define SEEK_CHUNK 256          // Multiplo de 8 para no partir los bloques SIMD
+#define PROJECTILE_CHUNK 64
+#define SEPARATION_CHUNK 512
+
+static unsigned char *orbCollected = NULL;
+static int *orbMergeTable = NULL;       // Tabla hash de OrbMerge (slot + 1, 0 si vacio)
+static int orbMergeSize = 0;            // Potencia de 2, al menos el doble de orbes
+static unsigned char *projectileExpired = NULL;
+static ProjectileHit *projectileHits = NULL;    // Monticulo de ProjectileCollision
+static float *seekFlowX = NULL;         // Direccion del campo en cada enemigo
+static float *seekFlowY = NULL;
+static int *seekNear = NULL;            // Enemigos junto a un obstaculo
+static int *seekContacts = NULL;
+static int *seekChunkContacts = NULL;
+static int *queryCandidates = NULL;     // Resultados de GridQueryCircle
+static int *querySplash = NULL;
+static float *separationX = NULL;       // Por slot de la rejilla (ver separation.h)
+static float *separationY = NULL;
+static float *separationRadius = NULL;
+static float *separationPushX = NULL;
+static float *separationPushY = NULL;
+
+// Eventos
+SimEvent simEvents[MAX_SIM_EVENTS] = { 0 };
+int simEventsCount = 0;
+
+// Generador aleatorio propio (xorshift32), para no depender de raylib
+
+// Igual que CheckCollisionCircles de raylib, sin enlazar contra la libreria
+static inline bool CirclesOverlap(Vector2 center1, float radius1, Vector2 center2, float radius2)
+{
+    float dx = center2.x - center1.x;
+    float dy = center2.y - center1.y;
+    return (dx*dx + dy*dy) <= (radius1 + radius2)*(radius1 + radius2);
+}
+
+//----------------------------------------------------------------------------------
+// Angulos y direcciones
+//----------------------------------------------------------------------------------
+// Lo unico de la simulacion que no son operaciones basicas de float. Con
+// SIM_FIXED_POINT (USE_FIXED_POINT=TRUE en el Makefile) se calcula en punto
+// fijo con las tablas de fixed.h y una grabacion da los mismos bits en x86-64
+// y en ARM; sin el, con la libm de la plataforma
+#if defined(SIM_FIXED_POINT)
+static inline Vector2 AngleDirection(int angle)
+{
+    return (Vector2){ FixedToFloat(FixedCos(angle)), FixedToFloat(FixedSin(angle)) };
+}
+
+// Vector unitario a degrees grados
+static Vector2 SimDirection(float degrees)
+{
+    return AngleDirection(FixedAngleFromDegrees(degrees));
+}
+
+// Direccion de v girada degrees grados
+static Vector2 SimRotateDirection(Vector2 v, float degrees)
+{
+    return AngleDirection(FixedAtan2(FixedFromFloat(v.y), FixedFromFloat(v.x)) + FixedAngleFromDegrees(degrees));
+}
+
+// direction girada hacia wanted como mucho maxTurn radianes
+static Vector2 SimTurnTowards(Vector2 direction, Vector2 wanted, float maxTurn)
+{
+    int current = FixedAtan2(FixedFromFloat(direction.y), FixedFromFloat(direction.x));
+    int target = FixedAtan2(FixedFromFloat(wanted.y), FixedFromFloat(wanted.x));
+    int limit = (int)(maxTurn*((float)FIXED_TURN/(2.0f*PI)));
+    int turn = FixedAngleWrap(target - current);
+    if (turn > limit) turn = limit;
+    if (turn < -limit) turn = -limit;
+    return AngleDirection(current + turn);
+}
+
+// Por el angulo y no con una raiz entera: cuesta lo mismo que un seno y
+// sobra precision (menos de 0.01 grados)
+static Vector2 SimNormalize(Vector2 v)
+{
+    Fixed x = FixedFromFloat(v.x);
+    Fixed y = FixedFromFloat(v.y);
+    if (x == 0 && y == 0) return (Vector2){ 0, 0 };
+    return AngleDirection(FixedAtan2(y, x));
+}
+#else
+static Vector2 SimDirection(float degrees)
+{
+    return (Vector2){ cosf(degrees*DEG2RAD), sinf(degrees*DEG2RAD) };
+}
+
+static Vector2 SimRotateDirection(Vector2 v, float degrees)
+{
+    float angle = atan2f(v.y, v.x) + degrees*DEG2RAD;
+    return (Vector2){ cosf(angle), sinf(angle) };
+}
+
+static Vector2 SimTurnTowards(Vector2 direction, Vector2 wanted, float maxTurn)
+{
+    float current = atan2f(direction.y, direction.x);
+    float turn = atan2f(wanted.y, wanted.x) - current;
+    if (turn > PI) turn -= 2.0f*PI;
+    if (turn < -PI) turn += 2.0f*PI;
+    turn = Clamp(turn, -maxTurn, maxTurn);
+    return (Vector2){ cosf(current + turn), sinf(current + turn) };
+}
+
+static Vector2 SimNormalize(Vector2 v)
+{
+    return Vector2Normalize(v);
+}
+#endif
+
+// Saca un circulo de los obstaculos que toca por el camino mas corto
+static void PushOutOfObstacles(float *x, float *y, float radius)
+{
+    for (int o = 0; o < obstacleCount; o++) {
+        Rectangle rect = obstacles[o];
+        float nearestX = Clamp(*x, rect.x, rect.x + rect.width);
+        float nearestY = Clamp(*y, rect.y, rect.y + rect.height);
+        float dx = *x - nearestX;
+        float dy = *y - nearestY;
+        float distance2 = dx*dx + dy*dy;
+        if (distance2 >= radius*radius) continue;
+
+        if (distance2 > 0.0f) {
+            float distance = sqrtf(distance2);
+            *x += dx/distance*(radius - distance);
+            *y += dy/distance*(radius - distance);
+        } else {
+            // Centro dentro del obstaculo: sale por el lado mas cercano
+            float left = *x - rect.x;
+            float right = rect.x + rect.width - *x;
+            float top = *y - rect.y;
+            float bottom = rect.y + rect.height - *y;
+            float nearest = fminf(fminf(left, right), fminf(top, bottom));
+            if (nearest == left) *x = rect.x - radius;
+            else if (nearest == right) *x = rect.x + rect.width + radius;
+            else if (nearest == top) *y = rect.y - radius;
+            else *y = rect.y + rect.height + radius;
+        }
+    }
+}
+
+// Hasta tres habilidades distintas al azar entre las disponibles
+static void RollUpgradeOffer(const int *available, int availableCount)
+{
+    int offered = (availableCount < 3)? availableCount : 3;
+    sim.upgradeOffer[0] = sim.upgradeOffer[1] = sim.upgradeOffer[2] = -1;
+
+    for (int i = 0; i < offered; ) {
+        int skill = available[SimRandomValue(0, availableCount - 1)];
+        bool repeated = false;
+        for (int j = 0; j < i; j++) if (sim.upgradeOffer[j] == skill) repeated = true;
+        if (!repeated) sim.upgradeOffer[i++] = skill;
+    }
+}
+
+// Decisiones de los menus: llegan como entrada del tick (y no desde el
+// dibujo) para que la grabacion de la partida las reproduzca
+static void ApplyMenuInput(const SimInput *input)
+{
+    if (sim.upgradeMenu && input->upgradeChoice >= 1 && input->upgradeChoice <= 3) {
+        int skill = sim.upgradeOffer[input->upgradeChoice - 1];
+        if (skill >= 0) {
+            setskillStatus(skill, true);
+            sim.upgradeMenu = false;
+        }
+    }
+    if (sim.upgradeMenu && input->closeMenu) sim.upgradeMenu = false;
+
+    if (input->restart && (sim.deathScreen || sim.winScreen)) {
+        sim.winScreen = false;
+        sim.deathScreen = false;
+        ResetGameState();
+    }
+
+    // Sin menu de mejoras abierto la partida continua
+    if (!sim.upgradeMenu) sim.menuActive = false;
+}
+
+//----------------------------------------------------------------------------------
+// Inicializacion y paso de simulacion
+//----------------------------------------------------------------------------------
+void SimInit(unsigned int seed)
+{
+    SimSetSeed(seed);
+    ResetGameState();
+    simEventsCount = 0;
+}
+
+// Posiciones al empezar el tick: el dibujo interpola desde aqui
+static void SavePrevious(void)
+{
+    sim.playerPrevious = sim.player.position;
+    memcpy(enemies.previousX, enemies.x, enemies.count*sizeof(float));
+    memcpy(enemies.previousY, enemies.y, enemies.count*sizeof(float));
+    for (int n = 0; n < projectilePool.count; n++) {
+        Projectile *projectile = &projectiles[projectilePool.dense[n]];
+        projectile->previous = projectile->position;
+    }
+    for (int n = 0; n < orbPool.count; n++) {
+        Orb *orb = &orbs[orbPool.dense[n]];
+        orb->previous = orb->position;
+    }
+}
+
+bool SimStep(const SimInput *input, float dt)
+{
+    simEventsCount = 0;
+    tickScale = dt*SIM_REFERENCE_RATE;
+    SavePrevious();
+    ApplyMenuInput(input);
+
+    // Cooldown visual tras resurrección
+    if (sim.resurrected && sim.resucitarCooldown < 0.5f) {
+        sim.resucitarCooldown += dt;
+        return false;
+    } else if (sim.resucitarCooldown >= 0.5f) {
+        sim.resucitarCooldown = 0.0f;
+        sim.resurrected = false;
+    }
+
+    if (!sim.menuActive && !sim.deathScreen && !sim.winScreen && !sim.resurrected) {
+        sim.totalGameTime += dt;
+        if (sim.totalGameTime >= 120.0f) {
+            sim.winScreen = true;
+            sim.menuActive = true;
+        }
+    }
+
+    if(sim.player.health <= 0 || (!sim.hasResurrect && sim.resurrected)) {
+        sim.deathScreen = true;
+        sim.menuActive = true;
+    }
+
+    if(sim.player.experience >= sim.player.level * 10) {
+        sim.player.level += 1;
+        sim.player.experience = 0;
+
+        // Verifica si aún quedan habilidades disponibles
+        int available[SKILLS_COUNT];
+        int availableCount = SimAvailableSkills(available);
+        if (availableCount > 0) {
+            RollUpgradeOffer(available, availableCount);
+            sim.upgradeMenu = true;
+            sim.menuActive = true;
+        }
+    }
+
+    // Timers
+    sim.timeSinceLastClick += dt;
+    sim.timer += dt;
+    // En modo horda el ritmo es fijo: la poblacion la limita maxEnemies
+    if (simMode == SIM_MODE_HORDE) sim.SpawnTimer += dt * HORDE_SPAWN_RATE;
+    else sim.SpawnTimer += dt * (1.5f + sim.totalGameTime * 0.3f);
+
+    // Spawner
+    if (sim.SpawnTimer >= 2.0f && !sim.menuActive) {
+        int enemies_to_spawn = (int)sim.SpawnTimer;
+        sim.SpawnTimer -= enemies_to_spawn;
+
+        PROFILE_ZONE(PROFILE_SPAWN) {
+            for (int i = 0; i < enemies_to_spawn; ++i) {
+                enemiesSpawn(&enemies);
+            }
+        }
+    }
+
+    // Furia Upgrade
+    if(sim.furiaActive && sim.furiaTimer <= 15.0f) {
+        sim.player.speed = sim.currentSpeed * 1.25f;
+        sim.player.damage = sim.currentDamage * 2;
+        sim.furiaTimer += dt;
+    }else{
+        sim.furiaActive = false;
+        sim.player.speed = sim.currentSpeed;
+        sim.player.damage = sim.currentDamage;
+        sim.furiaTimer = 0.0f;
+    }
+
+    // Iman Upgrade
+    if (sim.hasImanDeOrbes && sim.imanDeOrbesCount < 3) {
+        sim.radiusMultiplier += sim.radiusMultiplier * 0.25f;
+        sim.imanDeOrbesCount++;
+        sim.hasImanDeOrbes = false;
+
+        // Solo aqui cambia el radio: los orbes nuevos ya nacen con el bueno
+        for (int n = 0; n < orbPool.count; n++) {
+            orbs[orbPool.dense[n]].radius = ORB_RADIUS * sim.radiusMultiplier;
+        }
+    }
+
+    // Regen Upgrade
+    if (sim.hasRegeneracion){
+        sim.regenTimer += dt;
+        if(sim.regenTimer >= 60.0f){
+            sim.regenTimer = 0;
+            if (sim.player.health < sim.player.maxHealth){
+                sim.player.health++;
+                SimPushEvent(SIM_EVENT_REGEN, sim.player.position);
+            }
+        }
+    }
+
+    // Rafaga
+    if (sim.hasTormentaDeBalas){
+        sim.stormTimer += dt;
+        if(sim.stormTimer >= 3.0f){
+            sim.stormTimer = 0;
+            for (int degrees = 0; degrees < 360; degrees += 60) {
+                GenProjectiles(sim.player.position, Vector2Add(sim.player.position, SimDirection(degrees)), 1);
+            }
+            SimPushEvent(SIM_EVENT_SHOOT, sim.player.position);
+        }
+    }
+
+    if (sim.hasDisparoRapido && !sim.disparoRapidoAplicado) {
+        sim.shootVelocity += sim.shootVelocity * 0.25f;
+        sim.disparoRapidoAplicado = true;
+    }
+
+    // Disparo Mejorado
+    if (sim.hasDisparoMejorado && !sim.disparoMejoradoAplicado) {
+        sim.currentDamage += sim.currentDamage * 0.20f;
+        sim.player.damage = sim.currentDamage;
+        sim.disparoMejoradoAplicado = true;
+    }
+    // Movimiento Ágil
+    if (sim.hasMovimientoAgil && !sim.movimientoAgilAplicado) {
+        sim.currentSpeed += sim.currentSpeed * 0.20f;
+        sim.player.speed = sim.currentSpeed;
+        sim.movimientoAgilAplicado = true;
+    }
+
+    if(input->spawnOrb && !sim.menuActive) {
+        GenOrbs(input->aim, 1);
+    }
+    if(input->shoot && sim.timeSinceLastClick >= 0.3f/sim.shootVelocity && !sim.menuActive) {
+        sim.timeSinceLastClick = 0.0f;
+        // Sin hueco en el pool no se dispara
+        if (GenProjectiles(sim.player.position, input->aim, 1) > 0) {
+            if(sim.hasBifurcacion){
+                Vector2 offset = SimRotateDirection(Vector2Subtract(input->aim, sim.player.position), 5.0f);
+                Vector2 bifurcatedTarget = {
+                    sim.player.position.x + offset.x * 100.0f,
+                    sim.player.position.y + offset.y * 100.0f
+                };
+                GenProjectiles(sim.player.position, bifurcatedTarget, 1);
+            }
+            SimPushEvent(SIM_EVENT_SHOOT, sim.player.position);
+        }
+    }
+
+    if(!sim.menuActive) {
+        PROFILE_ZONE(PROFILE_UPDATE_PROJECTILES) UpdateProjectiles(projectiles);
+        // Collision logic
+        PROFILE_ZONE(PROFILE_ORB_COLLISION) {
+            // Los orbes amontonados se funden: el coste no crece con las bajas
+            sim.orbMergeTimer += dt;
+            if (sim.orbMergeTimer >= ORB_MERGE_INTERVAL) {
+                sim.orbMergeTimer = 0.0f;
+                OrbMerge(ORB_MERGE_CELL);
+            }
+            if (orbPool.count > maxOrbs*3/4) OrbMergeDown(maxOrbs/2);
+            OrbCollision(orbs);
+        }
+        PROFILE_ZONE(PROFILE_FLOW_FIELD) FlowFieldUpdate(&flowField, sim.player.position, FLOW_BUDGET);
+        PROFILE_ZONE(PROFILE_ENEMY_COLLISION) {
+            EnemyCollision(&enemies);
+            EnemyFlush(&enemies);
+        }
+        PROFILE_ZONE(PROFILE_GRID_BUILD) GridBuild(&enemyGrid, &enemies, enemies.count);
+        if (crowdSeparation) PROFILE_ZONE(PROFILE_SEPARATION) EnemySeparation(&enemies);
+
+        // Busca objetivos en la rejilla: tiene que ir despues de GridBuild
+        if (sim.timer >= 0.5f && sim.hasAliado) {
+            sim.timer = 0.0f;
+            ally(&enemies);
+        }
+        PROFILE_ZONE(PROFILE_PROJECTILE_COLLISION) {
+            ProjectileHoming(&enemies);
+            ProjectileCollision(&enemies);
+        }
+
+        Vector2 direction = (Vector2){ 0, 0 };
+        float step = sim.player.speed * sim.player.acceleration * tickScale;
+        if(input->up) direction.y -= step;
+        if(input->down) direction.y += step;
+        if(input->left) direction.x -= step;
+        if(input->right) direction.x += step;
+        Vector2Normalize(direction);
+        sim.player.position.x = Clamp(sim.player.position.x, -2500.0f, 2500.0f);
+        sim.player.position.y = Clamp(sim.player.position.y, -2500.0f, 2500.0f);
+        sim.player.position = Vector2Add(sim.player.position, direction);
+        if (FlowFieldNearObstacle(&flowField, sim.player.position.x, sim.player.position.y)) {
+            PushOutOfObstacles(&sim.player.position.x, &sim.player.position.y, sim.player.radius);
+        }
+
+        // Molinete de Hierro
+        if(sim.hasSierraGiratoria) {
+            sim.sawAngle += 1.0f * 3.0f * tickScale;
+
+            sim.sawTimer += dt;
+            if (sim.sawTimer >= SAW_INTERVAL) {
+                sim.sawTimer -= SAW_INTERVAL;
+                enemyTrigger(&enemies, SimSawPosition());
+            }
+        }
+
+        // Compacta los enemigos muertos en esta fase
+        EnemyFlush(&enemies);
+    }
+
+    return true;
+}
+
+void SimSetMode(SimMode mode)
+{
+    simMode = mode;
+}
+
+size_t SimMemoryUsed(void)
+{
+    return levelArena.used;
+}
+
+void SimSetSeed(unsigned int seed)
+{
+    sim.randomState = (seed != 0) ? seed : 0x2545F491u;
+}
+
+// Mismo contrato que GetRandomValue: rango inclusivo [min, max]
+int SimRandomValue(int min, int max)
+{
+    if (min > max) {
+        int tmp = max;
+        max = min;
+        min = tmp;
+    }
+    sim.randomState ^= sim.randomState << 13;
+    sim.randomState ^= sim.randomState >> 17;
+    sim.randomState ^= sim.randomState << 5;
+    return min + (int)(sim.randomState % (unsigned int)(max - min + 1));
+}
+
+void SimPushEvent(SimEventType type, Vector2 position)
+{
+    // Si se llena solo se pierden efectos visuales
+    if (simEventsCount < MAX_SIM_EVENTS) {
+        simEvents[simEventsCount].type = type;
+        simEvents[simEventsCount].position = position;
+        simEventsCount++;
+    }
+}
+
+// FNV-1a sobre los bytes de un bloque de estado
+static unsigned int HashBytes(unsigned int hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Huella del estado que decide la partida: dos ejecuciones con la misma
+// semilla y la misma entrada deben dar el mismo valor en cada tick
+unsigned int SimChecksum(void)
+{
+    unsigned int hash = 2166136261u;
+    int count = enemies.count;
+
+    // El estado entero: un campo nuevo de SimState entra sin tocar nada aqui
+    hash = HashBytes(hash, &sim, sizeof(sim));
+    hash = HashBytes(hash, &count, sizeof(count));
+    hash = HashBytes(hash, enemies.x, count*sizeof(float));
+    hash = HashBytes(hash, enemies.y, count*sizeof(float));
+    hash = HashBytes(hash, enemies.health, count*sizeof(int));
+
+    for (int n = 0; n < orbPool.count; n++) {
+        hash = HashBytes(hash, &orbs[orbPool.dense[n]].position, sizeof(Vector2));
+        hash = HashBytes(hash, &orbs[orbPool.dense[n]].value, sizeof(int));
+    }
+    for (int n = 0; n < projectilePool.count; n++) {
+        const Projectile *projectile = &projectiles[projectilePool.dense[n]];
+        hash = HashBytes(hash, &projectile->position, sizeof(Vector2));
+        hash = HashBytes(hash, &projectile->range, sizeof(float));
+    }
+
+    return hash;
+}
+
+Vector2 SimSawPosition(void)
+{
+    Vector2 direction = SimDirection(sim.sawAngle);
+    return (Vector2){
+        sim.player.position.x + 100 * direction.x,
+        sim.player.position.y + 100 * direction.y
+    };
+}
+
+int SimAvailableSkills(int *available)
+{
+    int availableCount = 0;
+    for (int i = 0; i < SKILLS_COUNT; i++) {
+        if (!getskillStatus(i)) {
+            if (i == IMAN_DE_ORBES && sim.imanDeOrbesCount >= 3) continue;
+            available[availableCount++] = i;
+        }
+    }
+    return availableCount;
+}
+
+const char *SimMathName(void)
+{
+#if defined(SIM_FIXED_POINT)
+    return "fixed";
+#else
+    return "float";
+#endif
+}
+
+//----------------------------------------------------------------------------------
+// Memoria de la partida
+//----------------------------------------------------------------------------------
+// Todo lo que crece con la partida sale de levelArena y se suelta de una vez
+// al reiniciar. Al llenarse, un arreglo se cambia por otro del doble (sin
+// pasar del limite del modo) y se copia lo vivo. Los Grow* no tocan el
+// estado si la arena no tiene memoria: devuelven false como un pool lleno.
+#define INITIAL_CAPACITY 64
+
+static void *LevelAlloc(const void *old, size_t oldSize, size_t size)
+{
+    void *memory = ArenaAlloc(&levelArena, size);
+    if (memory != NULL && oldSize > 0) memcpy(memory, old, oldSize);
+    return memory;
+}
+
+static int NextCapacity(int capacity, int needed, int limit)
+{
+    int next = (capacity > 0)? capacity : INITIAL_CAPACITY;
+    while (next < needed) next *= 2;
+    return (next < limit)? next : limit;
+}
+
+// Enemigos y todo lo que se indexa por enemigo (rejilla, contactos, consultas)
+static bool GrowEnemies(int needed)
+{
+    if (needed <= enemies.capacity) return true;
+    if (needed > maxEnemies) return false;
+
+    int capacity = NextCapacity(enemies.capacity, needed, maxEnemies);
+    size_t live = (size_t)enemies.count;
+    size_t size = (size_t)capacity;
+    int chunks = (capacity + SEEK_CHUNK - 1)/SEEK_CHUNK;
+
+    Enemies grown = enemies;
+    grown.x = LevelAlloc(enemies.x, live*sizeof(float), size*sizeof(float));
+    grown.y = LevelAlloc(enemies.y, live*sizeof(float), size*sizeof(float));
+    grown.previousX = LevelAlloc(enemies.previousX, live*sizeof(float), size*sizeof(float));
+    grown.previousY = LevelAlloc(enemies.previousY, live*sizeof(float), size*sizeof(float));
+    grown.speed = LevelAlloc(enemies.speed, live*sizeof(float), size*sizeof(float));
+    grown.radius = LevelAlloc(enemies.radius, live*sizeof(float), size*sizeof(float));
+    grown.health = LevelAlloc(enemies.health, live*sizeof(int), size*sizeof(int));
+    grown.maxHealth = LevelAlloc(enemies.maxHealth, live*sizeof(float), size*sizeof(float));
+    grown.enabled = LevelAlloc(enemies.enabled, live, size);
+    grown.spawnTime = LevelAlloc(enemies.spawnTime, live*sizeof(float), size*sizeof(float));
+    // La rejilla sigue siendo valida hasta el proximo GridBuild
+    int *cellItems = LevelAlloc(enemyGrid.cellItems, (size_t)enemyGrid.count*sizeof(int), size*sizeof(int));
+    int *itemCell = ArenaAlloc(&levelArena, size*sizeof(int));
+    float *flowX = ArenaAlloc(&levelArena, size*sizeof(float));
+    float *flowY = ArenaAlloc(&levelArena, size*sizeof(float));
+    int *near = ArenaAlloc(&levelArena, size*sizeof(int));
+    int *contacts = ArenaAlloc(&levelArena, size*sizeof(int));
+    int *chunkContacts = ArenaAlloc(&levelArena, (size_t)chunks*sizeof(int));
+    int *candidates = ArenaAlloc(&levelArena, size*sizeof(int));
+    int *splash = ArenaAlloc(&levelArena, size*sizeof(int));
+    float *sortedX = ArenaAlloc(&levelArena, (size + SEPARATION_PADDING)*sizeof(float));
+    float *sortedY = ArenaAlloc(&levelArena, (size + SEPARATION_PADDING)*sizeof(float));
+    float *sortedRadius = ArenaAlloc(&levelArena, (size + SEPARATION_PADDING)*sizeof(float));
+    float *pushX = ArenaAlloc(&levelArena, size*sizeof(float));
+    float *pushY = ArenaAlloc(&levelArena, size*sizeof(float));
+
+    if (grown.x == NULL || grown.y == NULL || grown.previousX == NULL || grown.previousY == NULL || grown.speed == NULL || grown.radius == NULL ||
+        grown.health == NULL || grown.maxHealth == NULL || grown.enabled == NULL || grown.spawnTime == NULL ||
+        cellItems == NULL || itemCell == NULL || flowX == NULL || flowY == NULL || near == NULL ||
+        contacts == NULL || chunkContacts == NULL ||
+        candidates == NULL || splash == NULL || sortedX == NULL || sortedY == NULL || sortedRadius == NULL ||
+        pushX == NULL || pushY == NULL) return false;
+
+    grown.capacity = capacity;
+    enemies = grown;
+    seekFlowX = flowX;
+    seekFlowY = flowY;
+    seekNear = near;
+    enemyGrid.cellItems = cellItems;
+    enemyGrid.itemCell = itemCell;
+    seekContacts = contacts;
+    seekChunkContacts = chunkContacts;
+    queryCandidates = candidates;
+    querySplash = splash;
+    separationX = sortedX;
+    separationY = sortedY;
+    separationRadius = sortedRadius;
+    separationPushX = pushX;
+    separationPushY = pushY;
+    return true;
+}
+
+// Los slots libres tambien se copian: el pool los reparte en cualquier orden
+static bool GrowOrbs(int needed)
+{
+    if (needed <= orbPool.capacity) return true;
+    if (needed > maxOrbs) return false;
+
+    int capacity = NextCapacity(orbPool.capacity, needed, maxOrbs);
+    size_t size = (size_t)capacity;
+    Orb *grown = LevelAlloc(orbs, (size_t)orbPool.capacity*sizeof(Orb), size*sizeof(Orb));
+    int *dense = ArenaAlloc(&levelArena, size*sizeof(int));
+    int *position = ArenaAlloc(&levelArena, size*sizeof(int));
+    unsigned char *collected = ArenaAlloc(&levelArena, size);
+    int tableSize = 1;
+    while (tableSize < 2*capacity) tableSize *= 2;
+    int *table = ArenaAlloc(&levelArena, (size_t)tableSize*sizeof(int));
+    if (grown == NULL || dense == NULL || position == NULL || collected == NULL || table == NULL) return false;
+
+    PoolGrow(&orbPool, dense, position, capacity);
+    orbs = grown;
+    orbCollected = collected;
+    orbMergeTable = table;
+    orbMergeSize = tableSize;
+    return true;
+}
+
+static bool GrowProjectiles(int needed)
+{
+    if (needed <= projectilePool.capacity) return true;
+    if (needed > maxProjectiles) return false;
+
+    int capacity = NextCapacity(projectilePool.capacity, needed, maxProjectiles);
+    size_t size = (size_t)capacity;
+    Projectile *grown = LevelAlloc(projectiles, (size_t)projectilePool.capacity*sizeof(Projectile), size*sizeof(Projectile));
+    int *dense = ArenaAlloc(&levelArena, size*sizeof(int));
+    int *position = ArenaAlloc(&levelArena, size*sizeof(int));
+    unsigned char *expired = ArenaAlloc(&levelArena, size);
+    ProjectileHit *hits = ArenaAlloc(&levelArena, size*sizeof(ProjectileHit));
+    if (grown == NULL || dense == NULL || position == NULL || expired == NULL || hits == NULL) return false;
+
+    PoolGrow(&projectilePool, dense, position, capacity);
+    projectiles = grown;
+    projectileExpired = expired;
+    projectileHits = hits;
+    return true;
+}
+
+// Nueva partida: se suelta la arena y se vuelve a la capacidad inicial con
+// los limites del modo elegido
+static void ResetLevelMemory(void)
+{
+    bool horde = (simMode == SIM_MODE_HORDE);
+    maxOrbs = horde? HORDE_MAX_ORBS : MAX_ORBS;
+    maxEnemies = horde? HORDE_MAX_ENEMIES : MAX_ENEMIES;
+    maxProjectiles = horde? HORDE_MAX_PROJECTILES : MAX_PROJECTILES;
+
+    ArenaReset(&levelArena);
+    enemies = (Enemies){ 0 };
+    orbs = NULL;
+    orbPool = (IndexPool){ 0 };
+    projectiles = NULL;
+    projectilePool = (IndexPool){ 0 };
+    memset(enemyGrid.cellStart, 0, sizeof(enemyGrid.cellStart));
+    enemyGrid.cellItems = NULL;
+    enemyGrid.itemCell = NULL;
+    enemyGrid.count = 0;
+
+    GrowEnemies(1);
+    GrowOrbs(1);
+    GrowProjectiles(1);
+}
+
+//----------------------------------------------------------------------------------
+// Estado de la partida e instantaneas
+//----------------------------------------------------------------------------------
+// Partida nueva: todo el estado a cero, relleno incluido (dos instantaneas
+// iguales son los mismos bytes y SimChecksum lo recorre entero), y los
+// valores de salida
+static void NewGameState(void)
+{
+    unsigned int seed = sim.randomState;
+    memset(&sim, 0, sizeof(sim));
+    sim.randomState = seed;
+    sim.player.speed = 2.0f;
+    sim.player.acceleration = 1.0f;
+    sim.player.radius = 10.0f;
+    sim.player.health = 5;
+    sim.player.damage = 10;
+    sim.player.level = 1;
+    sim.player.maxHealth = 5;
+    sim.skillDamage = 20;
+    sim.skillMultiplier = 1.0f;
+    sim.radiusMultiplier = 1.0f;
+    sim.currentSpeed = sim.player.speed;
+    sim.currentDamage = sim.player.damage;
+    sim.explotionDamage = 30;
+    sim.explotionRadius = 12.0f;
+    sim.corazonFracturadoMultiplier = 20.0f;
+    sim.shootVelocity = 1.0f;
+    sim.upgradeOffer[0] = sim.upgradeOffer[1] = sim.upgradeOffer[2] = -1;
+}
+
+// Instantanea: cabecera, SimState, campo de flujo (se rehace por partes, asi
+// que es estado), los arreglos de enemigos hasta count y, de orbes y
+// proyectiles, el orden del pool completo y los vivos en ese orden. La
+// rejilla y los auxiliares se rehacen en el siguiente tick.
+typedef struct SnapshotHeader {
+    char magic[4];                  // "SNAP"
+    unsigned int version;           // SIM_SNAPSHOT_VERSION
+    unsigned int layout[4];         // sizeof de SimState, FlowField, Orb y Projectile
+    unsigned int size;              // Bytes de toda la instantanea
+    int mode;
+    int enemyCount, enemyCapacity;
+    int orbCount, orbCapacity;
+    int projectileCount, projectileCapacity;
+} SnapshotHeader;
+
+#define ENEMY_FIELDS 10
+
+// Arreglos de Enemies en el orden de la instantanea, con el tamano de cada elemento
+static void EnemyFields(const Enemies *e, void **fields, size_t *sizes)
+{
+    void *f[ENEMY_FIELDS] = { e->x, e->y, e->previousX, e->previousY, e->speed, e->radius, e->health, e->maxHealth, e->enabled, e->spawnTime };
+    size_t s[ENEMY_FIELDS] = { sizeof(float), sizeof(float), sizeof(float), sizeof(float), sizeof(float), sizeof(float), sizeof(int), sizeof(float), 1, sizeof(float) };
+    memcpy(fields, f, sizeof(f));
+    memcpy(sizes, s, sizeof(s));
+}
+
+// Bytes de un enemigo entre todos los arreglos
+static size_t EnemyBytes(void)
+{
+    void *fields[ENEMY_FIELDS];
+    size_t sizes[ENEMY_FIELDS];
+    size_t bytes = 0;
+    EnemyFields(&enemies, fields, sizes);
+    for (int f = 0; f < ENEMY_FIELDS; f++) bytes += sizes[f];
+    return bytes;
+}
+
+// Donde empiezan los orbes (el orden del pool) y los proyectiles
+static size_t OrbSectionOffset(const SnapshotHeader *header)
+{
+    return sizeof(SnapshotHeader) + sizeof(SimState) + sizeof(FlowField) + (size_t)header->enemyCount*EnemyBytes();
+}
+
+static size_t ProjectileSectionOffset(const SnapshotHeader *header)
+{
+    return OrbSectionOffset(header) + (size_t)header->orbCapacity*sizeof(int) + (size_t)header->orbCount*sizeof(Orb);
+}
+
+static size_t SnapshotBytes(const SnapshotHeader *header)
+{
+    return ProjectileSectionOffset(header) + (size_t)header->projectileCapacity*sizeof(int) + (size_t)header->projectileCount*sizeof(Projectile);
+}
+
+static SnapshotHeader CurrentHeader(void)
+{
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "SNAP", 4);
+    header.version = SIM_SNAPSHOT_VERSION;
+    header.layout[0] = sizeof(SimState);
+    header.layout[1] = sizeof(FlowField);
+    header.layout[2] = sizeof(Orb);
+    header.layout[3] = sizeof(Projectile);
+    header.mode = simMode;
+    header.enemyCount = enemies.count;
+    header.enemyCapacity = enemies.capacity;
+    header.orbCount = orbPool.count;
+    header.orbCapacity = orbPool.capacity;
+    header.projectileCount = projectilePool.count;
+    header.projectileCapacity = projectilePool.capacity;
+    header.size = (unsigned int)SnapshotBytes(&header);
+    return header;
+}
+
+static unsigned char *SnapshotPut(unsigned char *at, const void *data, size_t size)
+{
+    if (size > 0) memcpy(at, data, size);
+    return at + size;
+}
+
+static const unsigned char *SnapshotGet(const unsigned char *at, void *data, size_t size)
+{
+    if (size > 0) memcpy(data, at, size);
+    return at + size;
+}
+
+size_t SimSnapshotSize(void)
+{
+    return CurrentHeader().size;
+}
+
+size_t SimSnapshotSave(void *buffer, size_t capacity)
+{
+    SnapshotHeader header = CurrentHeader();
+    if (buffer == NULL || capacity < header.size) return 0;
+
+    unsigned char *at = buffer;
+    at = SnapshotPut(at, &header, sizeof(header));
+    at = SnapshotPut(at, &sim, sizeof(sim));
+    at = SnapshotPut(at, &flowField, sizeof(flowField));
+
+    void *fields[ENEMY_FIELDS];
+    size_t sizes[ENEMY_FIELDS];
+    EnemyFields(&enemies, fields, sizes);
+    for (int f = 0; f < ENEMY_FIELDS; f++) at = SnapshotPut(at, fields[f], (size_t)enemies.count*sizes[f]);
+
+    at = SnapshotPut(at, orbPool.dense, (size_t)orbPool.capacity*sizeof(int));
+    for (int n = 0; n < orbPool.count; n++) at = SnapshotPut(at, &orbs[orbPool.dense[n]], sizeof(Orb));
+    at = SnapshotPut(at, projectilePool.dense, (size_t)projectilePool.capacity*sizeof(int));
+    for (int n = 0; n < projectilePool.count; n++) at = SnapshotPut(at, &projectiles[projectilePool.dense[n]], sizeof(Projectile));
+    return header.size;
+}
+
+// Un archivo corrupto no puede mandar a escribir fuera de los arreglos
+static bool DenseValid(const unsigned char *dense, int capacity)
+{
+    for (int n = 0; n < capacity; n++) {
+        int slot;
+        memcpy(&slot, dense + (size_t)n*sizeof(int), sizeof(int));
+        if (slot < 0 || slot >= capacity) return false;
+    }
+    return true;
+}
+
+// El orden del pool guardado pasa tal cual: los slots que se repartan despues
+// son los mismos que en la partida original
+static void RestorePool(IndexPool *pool, const unsigned char *dense, int count)
+{
+    memcpy(pool->dense, dense, (size_t)pool->capacity*sizeof(int));
+    for (int n = 0; n < pool->capacity; n++) pool->position[pool->dense[n]] = n;
+    pool->count = count;
+}
+
+SimRestoreResult SimSnapshotRestore(const void *data, size_t size)
+{
+    SnapshotHeader header;
+    if (data == NULL || size < sizeof(header)) return SIM_RESTORE_INVALID;
+    memcpy(&header, data, sizeof(header));
+
+    // Todo se comprueba antes de tocar nada: una instantanea invalida deja la partida como estaba
+    if (memcmp(header.magic, "SNAP", 4) != 0 || header.version != SIM_SNAPSHOT_VERSION) return SIM_RESTORE_INVALID;
+    if (header.layout[0] != sizeof(SimState) || header.layout[1] != sizeof(FlowField) ||
+        header.layout[2] != sizeof(Orb) || header.layout[3] != sizeof(Projectile)) return SIM_RESTORE_INVALID;
+    if (header.mode != SIM_MODE_NORMAL && header.mode != SIM_MODE_HORDE) return SIM_RESTORE_INVALID;
+    bool horde = (header.mode == SIM_MODE_HORDE);
+    if (header.enemyCapacity < 1 || header.enemyCapacity > (horde? HORDE_MAX_ENEMIES : MAX_ENEMIES) ||
+        header.orbCapacity < 1 || header.orbCapacity > (horde? HORDE_MAX_ORBS : MAX_ORBS) ||
+        header.projectileCapacity < 1 || header.projectileCapacity > (horde? HORDE_MAX_PROJECTILES : MAX_PROJECTILES)) return SIM_RESTORE_INVALID;
+    if (header.enemyCount < 0 || header.enemyCount > header.enemyCapacity ||
+        header.orbCount < 0 || header.orbCount > header.orbCapacity ||
+        header.projectileCount < 0 || header.projectileCount > header.projectileCapacity) return SIM_RESTORE_INVALID;
+    if (header.size != size || SnapshotBytes(&header) != size) return SIM_RESTORE_INVALID;
+    const unsigned char *bytes = (const unsigned char *)data;
+    if (!DenseValid(bytes + OrbSectionOffset(&header), header.orbCapacity) ||
+        !DenseValid(bytes + ProjectileSectionOffset(&header), header.projectileCapacity)) return SIM_RESTORE_INVALID;
+
+    // Memoria nueva de una vez a la capacidad guardada. La arena es una sola:
+    // si no cabe, la partida anterior ya se solto y se empieza una nueva en
+    // el modo que habia (nunca queda medio restaurada)
+    SimMode previousMode = simMode;
+    simMode = (SimMode)header.mode;
+    ResetLevelMemory();
+    if (!GrowEnemies(header.enemyCapacity) || !GrowOrbs(header.orbCapacity) || !GrowProjectiles(header.projectileCapacity)) {
+        simMode = previousMode;
+        ResetGameState();
+        simEventsCount = 0;
+        return SIM_RESTORE_NO_MEMORY;
+    }
+
+    const unsigned char *at = bytes + sizeof(header);
+    at = SnapshotGet(at, &sim, sizeof(sim));
+    at = SnapshotGet(at, &flowField, sizeof(flowField));
+
+    void *fields[ENEMY_FIELDS];
+    size_t sizes[ENEMY_FIELDS];
+    EnemyFields(&enemies, fields, sizes);
+    for (int f = 0; f < ENEMY_FIELDS; f++) at = SnapshotGet(at, fields[f], (size_t)header.enemyCount*sizes[f]);
+    enemies.count = header.enemyCount;
+
+    RestorePool(&orbPool, at, header.orbCount);
+    at += (size_t)header.orbCapacity*sizeof(int);
+    for (int n = 0; n < orbPool.count; n++) at = SnapshotGet(at, &orbs[orbPool.dense[n]], sizeof(Orb));
+    RestorePool(&projectilePool, at, header.projectileCount);
+    at += (size_t)header.projectileCapacity*sizeof(int);
+    for (int n = 0; n < projectilePool.count; n++) at = SnapshotGet(at, &projectiles[projectilePool.dense[n]], sizeof(Projectile));
+
+    simEventsCount = 0;
+    return SIM_RESTORE_OK;
+}
+
+//----------------------------------------------------------------------------------
+// Entidades
+//----------------------------------------------------------------------------------
+// Color por valor: verde, cian, violeta y dorado
+static Color OrbColor(int value) {
+    if (value >= 100) return (Color){ 255, 204, 0, 255 };
+    if (value >= 25) return (Color){ 190, 80, 255, 255 };
+    if (value >= 5) return (Color){ 30, 220, 255, 255 };
+    return (Color){ 30, 255, 30, 255 };
+}
+
+// Las funciones Gen* devuelven cuantas entidades crearon: con el pool lleno
+// se descartan las nuevas en lugar de pisar entidades vivas. Los orbes, en
+// cambio, se funden para hacer sitio: la experiencia no se pierde
+int GenOrbs(Vector2 position, int amount) {
+    int created = 0;
+    for (; created < amount; created++) {
+        if (!GrowOrbs(orbPool.count + 1)) {
+            OrbMergeDown(maxOrbs/2);
+            if (!GrowOrbs(orbPool.count + 1)) break;
+        }
+        int i = PoolAcquire(&orbPool);
+        float distance = SimRandomValue(0, 500) / 100.0f;
+        orbs[i].position = (Vector2){
+            position.x += distance,
+            position.y += distance
+        };
+        orbs[i].previous = orbs[i].position;
+        orbs[i].radius = ORB_RADIUS * sim.radiusMultiplier;
+        orbs[i].value = 1;
+        orbs[i].color = OrbColor(1);
+    }
+    return created;
+}
+
+static inline bool SameMergeCell(Vector2 a, Vector2 b, float inv) {
+    return floorf(a.x*inv) == floorf(b.x*inv) && floorf(a.y*inv) == floorf(b.y*inv);
+}
+
+// Funde los orbes que caen en la misma celda de lado cellSize: el que queda
+// (el ultimo en dense) suma el valor de los demas y conserva su posicion
+void OrbMerge(float cellSize) {
+    unsigned int mask = (unsigned int)orbMergeSize - 1;
+    float inv = 1.0f/cellSize;
+    memset(orbMergeTable, 0, (size_t)orbMergeSize*sizeof(int));
+
+    // De atras hacia adelante: liberar mueve el ultimo activo al hueco
+    for (int n = orbPool.count - 1; n >= 0; n--) {
+        int i = orbPool.dense[n];
+        int cx = (int)floorf(orbs[i].position.x*inv);
+        int cy = (int)floorf(orbs[i].position.y*inv);
+        unsigned int h = ((unsigned int)cx*73856093u ^ (unsigned int)cy*19349663u) & mask;
+
+        for (;; h = (h + 1) & mask) {
+            int other = orbMergeTable[h] - 1;
+            if (other < 0) {
+                orbMergeTable[h] = i + 1;
+                break;
+            }
+            if (SameMergeCell(orbs[other].position, orbs[i].position, inv)) {
+                orbs[other].value += orbs[i].value;
+                orbs[other].color = OrbColor(orbs[other].value);
+                PoolRelease(&orbPool, i);
+                break;
+            }
+        }
+    }
+}
+
+// Funde con celdas cada vez mayores hasta dejar como mucho target orbes.
+// Con celdas enormes solo quedan los de los cuatro cuadrantes: target >= 4
+void OrbMergeDown(int target) {
+    for (float cellSize = ORB_MERGE_CELL; orbPool.count > target; cellSize *= 2.0f) OrbMerge(cellSize);
+}
+
+int GenEnemies(Vector2 position, int amount) {
+    int created = 0;
+    for (; created < amount && GrowEnemies(enemies.count + 1); created++) {
+        int i = enemies.count++;
+        float distance = SimRandomValue(0, 500) / 100.0f;
+        enemies.x[i] = enemies.previousX[i] = position.x += distance;
+        enemies.y[i] = enemies.previousY[i] = position.y += distance;
+        enemies.radius[i] = ENEMY_RADIUS;
+        enemies.health[i] = 20;
+        enemies.maxHealth[i] = 20;
+        enemies.speed[i] = 1.35f;
+        enemies.enabled[i] = true;
+        enemies.spawnTime[i] = sim.totalGameTime;
+    }
+    return created;
+}
+
+int GenProjectiles(Vector2 position, Vector2 direction, int amount) {
+    int created = 0;
+    for (; created < amount && GrowProjectiles(projectilePool.count + 1); created++) {
+        int i = PoolAcquire(&projectilePool);
+        projectiles[i].position = position;
+        projectiles[i].previous = position;
+        projectiles[i].radius = PROJECTILE_RADIUS;
+        projectiles[i].speed = PROJECTILE_SPEED;
+        projectiles[i].damage = sim.player.damage;
+        projectiles[i].range = PROJECTILE_RANGE;
+        projectiles[i].direction = SimNormalize(Vector2Subtract(direction, projectiles[i].position));
+        projectiles[i].homing = false;
+    }
+    return created;
+}
+
+// Marca al enemigo como muerto; su hueco se cierra en EnemyFlush, asi los
+// indices siguen siendo validos durante toda la fase de colisiones
+void EnemyKill(Enemies *enemies, int index) {
+    enemies->enabled[index] = false;
+    enemies->speed[index] = 0.0f;
+}
+
+// Compacta [0, count) moviendo el ultimo vivo a cada hueco
+void EnemyFlush(Enemies *enemies) {
+    for (int i = enemies->count - 1; i >= 0; i--) {
+        if (enemies->enabled[i]) continue;
+        int last = --enemies->count;
+        if (i != last) {
+            enemies->x[i] = enemies->x[last];
+            enemies->y[i] = enemies->y[last];
+            enemies->previousX[i] = enemies->previousX[last];
+            enemies->previousY[i] = enemies->previousY[last];
+            enemies->speed[i] = enemies->speed[last];
+            enemies->radius[i] = enemies->radius[last];
+            enemies->health[i] = enemies->health[last];
+            enemies->maxHealth[i] = enemies->maxHealth[last];
+            enemies->enabled[i] = enemies->enabled[last];
+            enemies->spawnTime[i] = enemies->spawnTime[last];
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Fases en paralelo: cada trozo solo escribe sus propias entidades y su
+// franja de los arreglos de resultados; los efectos sobre el estado compartido
+// (liberar slots, experiencia, daño al jugador) se aplican despues en serie y
+// en orden de indice, igual que si todo hubiera corrido en un hilo.
+//----------------------------------------------------------------------------------
+// Iman: una sola pasada con la distancia al cuadrado; la raiz solo se
+// calcula para los que estan dentro del radio y se usa para todo lo demas
+static void OrbChunk(void *data, int begin, int end, int thread) {
+    Orb *orbs = (Orb *)data;
+    for (int n = begin; n < end; n++) {
+        int i = orbPool.dense[n];
+        float dx = sim.player.position.x - orbs[i].position.x;
+        float dy = sim.player.position.y - orbs[i].position.y;
+        float reach = sim.player.radius + orbs[i].radius*sim.radiusMultiplier;
+        float distance2 = dx*dx + dy*dy;
+        orbCollected[n] = false;
+        if (distance2 > reach*reach) continue;
+
+        // Sin pasarse del jugador aunque el tick sea largo
+        float distance = sqrtf(distance2);
+        if (distance > 0.0f) {
+            float step = fminf(4.0f*tickScale, distance)/distance;
+            orbs[i].position.x += dx*step;
+            orbs[i].position.y += dy*step;
+        }
+
+        // Orbe esta cerca del jugador
+        if (distance <= 2.0f) orbCollected[n] = true;
+    }
+}
+
+void OrbCollision(Orb *orbs) {
+    JobParallelFor(orbPool.count, ORB_CHUNK, OrbChunk, orbs);
+
+    // De atras hacia adelante: liberar mueve el ultimo activo al hueco
+    for (int n = orbPool.count - 1; n >= 0; n--) {
+        if (!orbCollected[n]) continue;
+        int i = orbPool.dense[n];
+        sim.player.experience += orbs[i].value;
+        PoolRelease(&orbPool, i);
+    }
+}
+
+// Cada trozo escribe sus contactos a partir de seekContacts[begin]
+static void SeekChunk(void *data, int begin, int end, int thread) {
+    Enemies *enemies = (Enemies *)data;
+    int *contacts = seekContacts + begin;
+    int *near = seekNear + begin;
+    int nearCount = FlowFieldSample(&flowField, enemies->x + begin, enemies->y + begin, end - begin,
+                                    seekFlowX + begin, seekFlowY + begin, near);
+    int found = SeekKernel(enemies->x + begin, enemies->y + begin, seekFlowX + begin, seekFlowY + begin,
+                           enemies->speed + begin, tickScale, enemies->radius + begin, enemies->enabled + begin, end - begin,
+                           sim.player.position, sim.player.radius, contacts);
+    for (int c = 0; c < found; c++) contacts[c] += begin;
+    seekChunkContacts[begin/SEEK_CHUNK] = found;
+
+    // Solo los que estan junto a un obstaculo miran la lista de obstaculos
+    for (int c = 0; c < nearCount; c++) {
+        int i = begin + near[c];
+        if (enemies->enabled[i]) PushOutOfObstacles(&enemies->x[i], &enemies->y[i], enemies->radius[i]);
+    }
+}
+
+void EnemyCollision(Enemies *enemies) {
+    // Todos los enemigos siguen el campo de flujo en una pasada vectorizada
+    int chunks = (enemies->count + SEEK_CHUNK - 1)/SEEK_CHUNK;
+    JobParallelFor(enemies->count, SEEK_CHUNK, SeekChunk, enemies);
+
+    // Enemigo esta cerca del jugador: se resuelven en orden de indice
+    for (int k = 0; k < chunks; k++) {
+        for (int c = 0; c < seekChunkContacts[k]; c++) {
+            int i = seekContacts[k*SEEK_CHUNK + c];
+            // Ya eliminado por un contacto anterior (o la resurreccion vacio la lista)
+            if (i >= enemies->count || !enemies->enabled[i]) continue;
+            EnemyKill(enemies, i);
+            PlayerTakeDamage(1, enemies);
+        }
+    }
+}
+
+// Empujes calculados en paralelo sobre las posiciones de GridBuild y
+// aplicados despues: el resultado no depende del orden ni de los hilos
+static void SeparationGatherChunk(void *data, int begin, int end, int thread) {
+    SeparationGather((const Enemies *)data, &enemyGrid, begin, end, separationX, separationY, separationRadius);
+}
+
+static void SeparationChunk(void *data, int begin, int end, int thread) {
+    float maxStep = *(const float *)data;
+    SeparationKernel(&enemyGrid, separationX, separationY, separationRadius, begin, end, maxStep, separationPushX, separationPushY);
+}
+
+void EnemySeparation(Enemies *enemies) {
+    JobParallelFor(enemyGrid.count, SEPARATION_CHUNK, SeparationGatherChunk, enemies);
+    for (int k = enemyGrid.count; k < enemyGrid.count + SEPARATION_PADDING; k++) {
+        separationX[k] = separationY[k] = separationRadius[k] = 0.0f;
+    }
+    float maxStep = SEPARATION_MAX_STEP*tickScale;
+    JobParallelFor(enemyGrid.count, SEPARATION_CHUNK, SeparationChunk, &maxStep);
+
+    for (int k = 0; k < enemyGrid.count; k++) {
+        int i = enemyGrid.cellItems[k];
+        enemies->x[i] += separationPushX[k];
+        enemies->y[i] += separationPushY[k];
+    }
+    // La rejilla no se reconstruye: las consultas se amplian lo que se movieron
+    enemyGrid.slack = maxStep;
+}
+
+// Cada teledirigido gira hacia el enemigo vivo mas cercano, como mucho
+// HOMING_TURN por tick; sin ninguno a HOMING_RANGE sigue recto
+static void HomingChunk(void *data, int begin, int end, int thread) {
+    const Enemies *enemies = (const Enemies *)data;
+    for (int n = begin; n < end; n++) {
+        Projectile *projectile = &projectiles[projectilePool.dense[n]];
+        if (!projectile->homing) continue;
+        int target = GridNearest(&enemyGrid, enemies, projectile->position, HOMING_RANGE);
+        if (target < 0) continue;
+
+        Vector2 wanted = Vector2Subtract(EnemyPosition(enemies, target), projectile->position);
+        projectile->direction = SimTurnTowards(projectile->direction, wanted, HOMING_TURN*tickScale);
+    }
+}
+
+void ProjectileHoming(Enemies *enemies) {
+    JobParallelFor(projectilePool.count, PROJECTILE_CHUNK, HomingChunk, enemies);
+}
+
+// Primer instante t en [0, 1] en que un circulo que va de start a
+// start + delta toca a otro quieto en center (radius = suma de los radios);
+// -1 si no llega a tocarlo
+static float SweptCircleTime(Vector2 start, Vector2 delta, Vector2 center, float radius)
+{
+    float mx = start.x - center.x;
+    float my = start.y - center.y;
+    float c = mx*mx + my*my - radius*radius;
+    if (c <= 0.0f) return 0.0f;     // Ya se tocan al empezar
+
+    float a = delta.x*delta.x + delta.y*delta.y;
+    float b = mx*delta.x + my*delta.y;
+    if (a == 0.0f || b >= 0.0f) return -1.0f;   // Quieto o alejandose
+    float discriminant = b*b - a*c;
+    if (discriminant < 0.0f) return -1.0f;
+    float t = (-b - sqrtf(discriminant))/a;
+    return (t <= 1.0f)? t : -1.0f;
+}
+
+// Enemigo vivo que el proyectil toca antes a lo largo de su recorrido en este
+// tick (de previous a position), -1 si ninguno. Los enemigos se toman donde
+// estan al final del tick: se mueven mucho menos que un proyectil. Recorre
+// las celdas directamente (sin ordenar candidatos como GridQueryCircle)
+static int ProjectileFirstHit(const Enemies *enemies, const Projectile *projectile, float *time)
+{
+    Vector2 delta = Vector2Subtract(projectile->position, projectile->previous);
+    Vector2 middle = Vector2Add(projectile->previous, Vector2Scale(delta, 0.5f));
+    float reach = 0.5f*Vector2Length(delta) + projectile->radius + ENEMY_RADIUS;
+    int minX, maxX, minY, maxY;
+    GridCircleCells(&enemyGrid, middle, reach, &minX, &maxX, &minY, &maxY);
+
+    // A igual instante gana el indice menor, sea cual sea el orden de las celdas
+    int first = -1;
+    for (int cy = minY; cy <= maxY; cy++) {
+        for (int cx = minX; cx <= maxX; cx++) {
+            int cell = cy*GRID_DIM + cx;
+            for (int k = enemyGrid.cellStart[cell]; k < enemyGrid.cellStart[cell + 1]; k++) {
+                int j = enemyGrid.cellItems[k];
+                if (!enemies->enabled[j]) continue;
+                float t = SweptCircleTime(projectile->previous, delta, EnemyPosition(enemies, j), projectile->radius + enemies->radius[j]);
+                if (t >= 0.0f && (first < 0 || t < *time || (t == *time && j < first))) {
+                    first = j;
+                    *time = t;
+                }
+            }
+        }
+    }
+    return first;
+}
+
+static inline bool HitBefore(const ProjectileHit *a, const ProjectileHit *b)
+{
+    return (a->time != b->time)? a->time < b->time : a->slot < b->slot;
+}
+
+static void HitPush(ProjectileHit *heap, int *count, ProjectileHit hit)
+{
+    int i = (*count)++;
+    while (i > 0 && HitBefore(&hit, &heap[(i - 1)/2])) {
+        heap[i] = heap[(i - 1)/2];
+        i = (i - 1)/2;
+    }
+    heap[i] = hit;
+}
+
+static ProjectileHit HitPop(ProjectileHit *heap, int *count)
+{
+    ProjectileHit top = heap[0];
+    ProjectileHit last = heap[--(*count)];
+    int i = 0;
+    for (;;) {
+        int child = 2*i + 1;
+        if (child >= *count) break;
+        if (child + 1 < *count && HitBefore(&heap[child + 1], &heap[child])) child++;
+        if (!HitBefore(&heap[child], &last)) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    if (*count > 0) heap[i] = last;
+    return top;
+}
+
+// Colision continua: cada proyectil barre su recorrido del tick, asi que no
+// atraviesa enemigos aunque vaya rapido o el tick sea largo. Los impactos se
+// resuelven por orden de instante (monticulo); si el enemigo ya murio por
+// otro anterior, el proyectil sigue y se busca su siguiente impacto.
+// Usa el arreglo global de proyectiles: Almas Errantes puede hacerlo crecer
+// (y cambiarlo de sitio) en mitad del recorrido; los que crea quedan fuera
+// de este tick
+void ProjectileCollision(Enemies *enemies) {
+    int *splash = querySplash;
+    ProjectileHit *heap = projectileHits;
+    int heapCount = 0;
+
+    for (int n = 0; n < projectilePool.count; n++) {
+        ProjectileHit hit = { 0.0f, projectilePool.dense[n], -1 };
+        hit.enemy = ProjectileFirstHit(enemies, &projectiles[hit.slot], &hit.time);
+        if (hit.enemy >= 0) HitPush(heap, &heapCount, hit);
+    }
+
+    while (heapCount > 0) {
+        ProjectileHit hit = HitPop(heap, &heapCount);
+        int i = hit.slot;
+        int j = hit.enemy;
+        if (!enemies->enabled[j]) {
+            hit.enemy = ProjectileFirstHit(enemies, &projectiles[i], &hit.time);
+            if (hit.enemy >= 0) HitPush(heap, &heapCount, hit);
+            continue;
+        }
+
+        Vector2 impact = Vector2Lerp(projectiles[i].previous, projectiles[i].position, hit.time);
+        // Corazon fracturado
+        if(sim.hasCorazonFracturado && sim.player.health <= 1) {
+            SimPushEvent(SIM_EVENT_CORAZON_EXPLOSION, impact);
+            float splashRadius = projectiles[i].radius*sim.corazonFracturadoMultiplier;
+            int splashCount = GridEnemiesInCircle(&enemyGrid, enemies, impact, splashRadius, splash, enemies->capacity);
+            for (int s = 0; s < splashCount; s++) {
+                EnemyTakeDamage(enemies, splash[s], projectiles[i].damage);
+            }
+        }
+        // El slot puede reutilizarse dentro de EnemyTakeDamage
+        int damage = projectiles[i].damage;
+        PoolRelease(&projectilePool, i);
+        EnemyTakeDamage(enemies, j, damage);
+    }
+}
+
+// Un enemigo ya muerto en este tick (la salpicadura del Corazon puede matar
+// al objetivo del impacto) no vuelve a morir ni suelta otro orbe
+void EnemyTakeDamage(Enemies *enemies, int index, int damage){
+    if (!enemies->enabled[index]) return;
+    enemies->health[index] -= damage;
+    if (enemies->health[index] <= 0) {
+        Vector2 position = EnemyPosition(enemies, index);
+        EnemyKill(enemies, index);
+        sim.enemiesKilled++;
+        GenOrbs(position, 1);
+        sim.orbsCollected++;
+        SimPushEvent(SIM_EVENT_ENEMY_DEATH, position);
+        if(sim.hasAlmasErrantes) {
+            for (int degrees = 30; degrees < 360; degrees += 120) {
+                GenProjectiles(position, Vector2Add(position, SimDirection(degrees)), 1);
+            }
+            SimPushEvent(SIM_EVENT_SHOOT, position);
+        }
+    }
+}
+void PlayerTakeDamage(int damage, Enemies *enemies) {
+    PushEnemiesAway(enemies);
+    sim.player.health -= damage;
+
+    for(int i = 0; i < enemies->count; i++) {
+        if(enemies->enabled[i] && sim.hasExplosion &&
+            CirclesOverlap(sim.player.position, sim.player.radius * sim.explotionRadius, EnemyPosition(enemies, i), enemies->radius[i])) {
+            SimPushEvent(SIM_EVENT_VENGANZA_EXPLOSION, sim.player.position);
+            EnemyTakeDamage(enemies, i, sim.explotionDamage);
+        }
+    }
+
+    if (sim.player.health <= 0) {
+        sim.player.health = 0;
+
+        // Resucitar al jugador
+        if (sim.hasResurrect && !sim.resurrected) {
+            sim.player.health++;
+            sim.player.position = (Vector2){ 0, 0 };
+
+            // La capa de render limpia sus animaciones al recibir el evento
+            SimPushEvent(SIM_EVENT_RESURRECT, sim.player.position);
+            sim.resurrected = true;
+
+            // Limpiar enemigos, proyectiles y orbes
+            enemies->count = 0;
+            PoolClear(&projectilePool);
+            PoolClear(&orbPool);
+            sim.upgradeMenu = false;
+            sim.menuActive = false;
+        }
+    }
+}
+
+void PushEnemiesAway(Enemies *enemies) {
+    for (int i = 0; i < enemies->count; i++) {
+        if (enemies->enabled[i]) {
+            Vector2 direction = Vector2Subtract(EnemyPosition(enemies, i), sim.player.position);
+            float distance = Vector2Length(direction);
+
+            if (distance > 0.0f && distance < 10.0f) {
+                direction = Vector2Scale(SimNormalize(direction), 120.0f - distance);
+                enemies->x[i] += direction.x;
+                enemies->y[i] += direction.y;
+            }
+        }
+    }
+}
+
+void enemiesSpawn(Enemies *enemies) {
+    if (enemies->count < maxEnemies) {
+        float x, y;
+        // Nunca dentro de un obstaculo
+        do {
+            do {
+                x = SimRandomValue(sim.player.position.x - 2000, sim.player.position.x + 2000);
+            } while (x >= sim.player.position.x - 700 && x <= sim.player.position.x + 700);
+
+            do {
+                y = SimRandomValue(sim.player.position.y - 2000, sim.player.position.y + 2000);
+            } while (y >= sim.player.position.y - 700 && y <= sim.player.position.y + 700);
+        } while (FlowFieldBlocked(&flowField, x, y));
+
+        // Crear enemigo en la nueva posición
+        GenEnemies((Vector2){ x, y }, 1);
+
+        // Humo de aparicion
+        SimPushEvent(SIM_EVENT_ENEMY_SPAWN, (Vector2){ x, y });
+    }
+}
+
+static void ProjectileChunk(void *data, int begin, int end, int thread) {
+    Projectile *projectiles = (Projectile *)data;
+    for (int n = begin; n < end; n++) {
+        int i = projectilePool.dense[n];
+        // Actualizar la posición del proyectil
+        float step = projectiles[i].speed*tickScale;
+        projectiles[i].position = Vector2Add(projectiles[i].position,
+            Vector2Scale(projectiles[i].direction, step));
+
+        projectiles[i].range -= step;
+
+        // Fuera de los límites, sin alcance o contra un obstaculo
+        projectileExpired[n] = projectiles[i].range <= 0.0f ||
+            FlowFieldBlocked(&flowField, projectiles[i].position.x, projectiles[i].position.y) ||
+            projectiles[i].position.x < -5700 || projectiles[i].position.x > 5700 ||
+            projectiles[i].position.y < -5700 || projectiles[i].position.y > 5700;
+    }
+}
+
+void UpdateProjectiles(Projectile *projectiles) {
+    JobParallelFor(projectilePool.count, PROJECTILE_CHUNK, ProjectileChunk, projectiles);
+
+    for (int n = projectilePool.count - 1; n >= 0; n--) {
+        if (projectileExpired[n]) PoolRelease(&projectilePool, projectilePool.dense[n]);
+    }
+}
+
+void enemyTrigger(Enemies *enemies, Vector2 position) {
+    int *targets = queryCandidates;
+    int count = GridEnemiesInCircle(&enemyGrid, enemies, position, 10.0f, targets, enemies->capacity);
+
+    for (int c = 0; c < count; c++) {
+        EnemyTakeDamage(enemies, targets[c], sim.skillDamage*sim.skillMultiplier);
+    }
+}
+
+// Heraldos de Acero: un disparo teledirigido a cada uno de los mas cercanos
+void ally(Enemies *enemies) {
+    int targets[ALLY_TARGETS];
+    int count = GridKNearest(&enemyGrid, enemies, sim.player.position, ALLY_RANGE, ALLY_TARGETS, targets);
+
+    for (int t = 0; t < count; t++) {
+        // GenProjectiles deja el slot nuevo al final de los activos
+        if (GenProjectiles(Vector2Add(sim.player.position, (Vector2){ 15, 5 }), EnemyPosition(enemies, targets[t]), 1) > 0) {
+            projectiles[projectilePool.dense[projectilePool.count - 1]].homing = true;
+        }
+    }
+    if (count > 0) SimPushEvent(SIM_EVENT_SHOOT, sim.player.position);
+}
+
+void setskillStatus(int skillIndex, bool status) {
+    switch (skillIndex) {
+        case 0: sim.hasResurrect = status; break;
+        case 1: sim.hasDisparoMejorado = status; break;
+        case 2: sim.hasMovimientoAgil = status; break;
+        case 3: sim.hasRegeneracion = status; break;
+        case 4: sim.hasBifurcacion = status; break;
+        case 5: sim.hasAliado = status; break;
+        case 6: sim.hasTormentaDeBalas = status; break;
+        case 7: sim.hasFuria = status; break;
+        case 8: sim.hasExplosion = status; break;
+        case 9: sim.hasImanDeOrbes = status; break;
+        case 10: sim.hasDisparoRapido = status; break;
+        case 11: sim.hasAlmasErrantes = status; break;
+        case 12: sim.hasSierraGiratoria = status; break;
+        case 13: sim.hasCorazonFracturado = status; break;
+        default: break;
+    }
+}
+
+bool getskillStatus(int skillIndex) {
+    switch (skillIndex) {
+        case 0: return sim.hasResurrect;
+        case 1: return sim.hasDisparoMejorado;
+        case 2: return sim.hasMovimientoAgil;
+        case 3: return sim.hasRegeneracion;
+        case 4: return sim.hasBifurcacion;
+        case 5: return sim.hasAliado;
+        case 6: return sim.hasTormentaDeBalas;
+        case 7: return sim.hasFuria;
+        case 8: return sim.hasExplosion;
+        case 9: return sim.hasImanDeOrbes;
+        case 10: return sim.hasDisparoRapido;
+        case 11: return sim.hasAlmasErrantes;
+        case 12: return sim.hasSierraGiratoria;
+        case 13: return sim.hasCorazonFracturado;
+        default: return false;
+    }
+}
+
+// Partida nueva desde NewGameState(); el generador aleatorio sigue su
+// secuencia (una repeticion con reinicios depende de ello)
+void ResetGameState() {
+    NewGameState();
+
+    // Limpiar entidades (y la memoria de la partida anterior)
+    ResetLevelMemory();
+
+    // Campo de flujo completo desde el centro: al empezar no importa el tiron
+    FlowFieldInit(&flowField, obstacles, obstacleCount);
+    FlowFieldUpdate(&flowField, sim.player.position, 2*GRID_CELLS);
+}
@@ -0,0 +1,286 @@
+#ifndef SIM_H
+#define SIM_H
+
+// Nucleo de simulacion: toda la logica de juego, sin ventana, sin dibujo y sin
+// lectura directa de teclado/raton. raylib.h solo se usa por sus tipos.
+#include "raylib.h"
+#include "pool.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Limites del modo normal y del modo horda. Los arreglos no se reservan con
+// ese tamaño: crecen bajo demanda desde la arena de la partida hasta el limite
+#define MAX_ORBS 256
+#define MAX_ENEMIES 512
+#define MAX_PROJECTILES 32
+#define HORDE_MAX_ORBS 16384
+#define HORDE_MAX_ENEMIES 50000
+#define HORDE_MAX_PROJECTILES 4096
+#define HORDE_SPAWN_RATE 5000.0f // Enemigos por segundo hasta llenar la horda
+#define ORB_RADIUS 70.0f
+#define ORB_MERGE_CELL 32.0f    // Orbes en la misma celda de este lado se funden en uno
+#define ORB_MERGE_INTERVAL 0.25f // Segundos entre pasadas de fusion
+#define ENEMY_RADIUS 15.0f
+#define PROJECTILE_RADIUS 5.0f
+#define PROJECTILE_SPEED 4.0f
+#define PROJECTILE_RANGE 1500.0f // Distancia maxima antes de liberar el slot
+#define HOMING_RANGE 400.0f     // Un proyectil teledirigido busca enemigos hasta aqui
+#define HOMING_TURN (4.0f*DEG2RAD) // Giro maximo por tick
+#define ALLY_TARGETS 3          // Disparos por rafaga de Heraldos de Acero
+#define ALLY_RANGE 1000.0f
+#define IMAN_DE_ORBES 5
+#define SKILLS_COUNT 14
+#define SAW_INTERVAL (10.0f/60.0f)  // Segundos entre golpes de la sierra
+// Las velocidades (speed, PROJECTILE_SPEED, HOMING_TURN...) son por tick a
+// este ritmo; con otro dt se escalan por dt*SIM_REFERENCE_RATE
+#define SIM_REFERENCE_RATE 60.0f
+#define SIM_TICK_RATE 60        // Ticks por segundo del juego si no se elige otro
+#define MAX_SIM_EVENTS 1024
+#define SIM_SNAPSHOT_VERSION 2  // Formato de SimSnapshotSave (2: habilidades dentro de SimState)
+
+typedef struct Player {
+    Vector2 position;
+    float speed;
+    float acceleration;
+    float radius;
+    int health;
+    int damage;
+    int level;
+    int experience;
+    int maxHealth;
+} Player;
+
+typedef struct Orb{
+    Vector2 position;
+    Vector2 previous;   // Al empezar el tick, para interpolar al dibujar
+    Color color;
+    float radius;       // Radio de atraccion (ORB_RADIUS*radiusMultiplier)
+    int value;          // Experiencia que da: crece al fundirse con otros
+} Orb;
+
+// Enemigos como estructura de arreglos: cada campo contiguo en memoria.
+// Los vivos ocupan [0, count); al morir se marcan con enabled = 0 y al final
+// de la fase se compactan moviendo el ultimo al hueco (EnemyFlush).
+// Los arreglos cambian de sitio al crecer: no guardar punteros a ellos
+// entre llamadas que puedan crear enemigos.
+typedef struct Enemies {
+    float *x;
+    float *y;
+    float *previousX;   // Al empezar el tick, para interpolar al dibujar
+    float *previousY;
+    float *speed;
+    float *radius;
+    int *health;
+    float *maxHealth;
+    unsigned char *enabled;
+    float *spawnTime;   // totalGameTime al aparecer (fase de la animacion)
+    int count;
+    int capacity;
+} Enemies;
+
+typedef struct Projectile{
+    Vector2 position;
+    Vector2 previous;   // Al empezar el tick, para interpolar al dibujar
+    float speed;
+    float radius;
+    int damage;
+    float range;        // Distancia que le queda por recorrer
+    Vector2 direction;
+    bool homing;        // Gira hacia el enemigo mas cercano (ver ProjectileHoming)
+} Projectile;
+
+typedef enum SimMode {
+    SIM_MODE_NORMAL = 0,
+    SIM_MODE_HORDE      // Decenas de miles de enemigos a la vez
+} SimMode;
+
+// Resultado de SimSnapshotRestore
+typedef enum SimRestoreResult {
+    SIM_RESTORE_OK = 0,
+    SIM_RESTORE_INVALID,    // De otra version o corrupta: la partida sigue como estaba
+    SIM_RESTORE_NO_MEMORY   // No cabe: la partida queda reiniciada (como ResetGameState)
+} SimRestoreResult;
+
+// Entrada de un tick, ya traducida a coordenadas de mundo
+typedef struct SimInput {
+    bool up;
+    bool down;
+    bool left;
+    bool right;
+    bool shoot;         // Clic izquierdo (pulsado este tick)
+    bool spawnOrb;      // Debug: clic derecho
+    bool restart;       // R en la pantalla de muerte o victoria
+    bool closeMenu;     // Cancelar/Escape en el menu de mejoras
+    int upgradeChoice;  // Carta elegida en el menu de mejoras (1-3), 0 si ninguna
+    Vector2 aim;        // Punto de mira en coordenadas de mundo
+} SimInput;
+
+// Eventos que la simulacion emite para efectos visuales y sonido
+typedef enum SimEventType {
+    SIM_EVENT_ENEMY_SPAWN = 0,
+    SIM_EVENT_ENEMY_DEATH,
+    SIM_EVENT_CORAZON_EXPLOSION,
+    SIM_EVENT_VENGANZA_EXPLOSION,
+    SIM_EVENT_REGEN,
+    SIM_EVENT_RESURRECT,
+    SIM_EVENT_SHOOT
+} SimEventType;
+
+typedef struct SimEvent {
+    SimEventType type;
+    Vector2 position;
+} SimEvent;
+
+// Todo lo que decide la partida y no es una entidad vive aqui y solo aqui:
+// una partida nueva parte de cero con los valores de ResetGameState(), las
+// instantaneas lo copian tal cual y SimChecksum lo recorre entero. Una
+// variable nueva de la simulacion se declara en este struct y queda cubierta.
+typedef struct SimState {
+    Player player;
+    Vector2 playerPrevious;     // Posicion al empezar el ultimo tick
+    unsigned int randomState;
+
+    // Timers
+    float timer;
+    float totalGameTime;
+    float timeSinceLastClick;
+    float SpawnTimer;
+    float furiaTimer;
+    float regenTimer;
+    float stormTimer;
+    float sawAngle;
+    float sawTimer;
+    float resucitarCooldown;
+    float orbMergeTimer;
+
+    // Estadisticas
+    int enemiesKilled;
+    int orbsCollected;
+    int projectilesFired;
+    int projectilesHit;
+
+    // Habilidades
+    int skillDamage;
+    float skillMultiplier;
+    float radiusMultiplier;
+    float currentSpeed;
+    int currentDamage;
+    bool furiaActive;
+    int explotionDamage;
+    float explotionRadius;      // Multiplicado por player.radius
+    float corazonFracturadoMultiplier;
+    bool resurrected;
+    float shootVelocity;
+    bool hasResurrect;
+    bool hasDisparoMejorado;
+    bool hasMovimientoAgil;
+    bool hasRegeneracion;
+    bool hasBifurcacion;
+    bool hasAliado;
+    bool hasTormentaDeBalas;
+    bool hasFuria;
+    bool hasExplosion;
+    bool hasImanDeOrbes;
+    bool hasDisparoRapido;
+    bool hasAlmasErrantes;
+    bool hasSierraGiratoria;
+    bool hasCorazonFracturado;
+    int imanDeOrbesCount;
+    bool disparoRapidoAplicado;
+    bool disparoMejoradoAplicado;
+    bool movimientoAgilAplicado;
+
+    // Flujo de partida
+    int upgradeOffer[3];        // Habilidades del menu de mejoras (-1 si la carta esta vacia)
+    bool upgradeMenu;
+    bool deathScreen;
+    bool menuActive;
+    bool winScreen;
+} SimState;
+
+//----------------------------------------------------------------------------------
+// Estado de la simulacion
+//----------------------------------------------------------------------------------
+extern SimMode simMode;
+extern int maxOrbs;             // Limites del modo actual
+extern int maxEnemies;
+extern int maxProjectiles;
+extern bool crowdSeparation;    // Separacion entre enemigos (se puede apagar para comparar)
+extern const Rectangle obstacles[]; // Obstaculos fijos de la arena
+extern const int obstacleCount;
+extern SimState sim;
+extern Orb *orbs;               // Indexado por slot de orbPool
+extern IndexPool orbPool;
+extern Enemies enemies;
+extern Projectile *projectiles; // Indexado por slot de projectilePool
+extern IndexPool projectilePool;
+
+// Eventos del ultimo tick
+extern SimEvent simEvents[MAX_SIM_EVENTS];
+extern int simEventsCount;
+
+static inline Vector2 EnemyPosition(const Enemies *enemies, int index)
+{
+    return (Vector2){ enemies->x[index], enemies->y[index] };
+}
+
+// Para dibujar entre dos ticks: alpha = 0 es el anterior, 1 el ultimo
+static inline Vector2 SimLerp(Vector2 previous, Vector2 current, float alpha)
+{
+    return (Vector2){ previous.x + (current.x - previous.x)*alpha, previous.y + (current.y - previous.y)*alpha };
+}
+
+static inline Vector2 EnemyRenderPosition(const Enemies *enemies, int index, float alpha)
+{
+    return SimLerp((Vector2){ enemies->previousX[index], enemies->previousY[index] }, EnemyPosition(enemies, index), alpha);
+}
+
+//----------------------------------------------------------------------------------
+// Funciones
+//----------------------------------------------------------------------------------
+void SimInit(unsigned int seed);
+void SimSetMode(SimMode mode);  // Se aplica en el siguiente SimInit o reinicio
+size_t SimMemoryUsed(void);     // Bytes pedidos a la arena de la partida
+// dt en segundos; el juego usa siempre el mismo (1/SIM_TICK_RATE o el elegido)
+bool SimStep(const SimInput *input, float dt); // false si el tick quedo congelado (resurreccion)
+void SimSetSeed(unsigned int seed);
+int SimRandomValue(int min, int max);
+void SimPushEvent(SimEventType type, Vector2 position);
+unsigned int SimChecksum(void);
+Vector2 SimSawPosition(void);
+int SimAvailableSkills(int *available);
+// Como se calculan angulos y direcciones: "fixed" (SIM_FIXED_POINT, igual en
+// todas las plataformas) o "float" (libm de la plataforma)
+const char *SimMathName(void);
+// Instantanea binaria de toda la partida (estado, entidades y campo de flujo)
+// para reiniciar al instante, suspender o medir desde un punto de control.
+// Solo sirve para el mismo ejecutable: el formato son los structs tal cual.
+// Save devuelve los bytes escritos, 0 si no caben en capacity.
+size_t SimSnapshotSize(void);
+size_t SimSnapshotSave(void *buffer, size_t capacity);
+SimRestoreResult SimSnapshotRestore(const void *data, size_t size);
+
+int GenOrbs(Vector2 position, int amount);
+int GenEnemies(Vector2 position, int amount);
+int GenProjectiles(Vector2 position, Vector2 direction, int amount);
+void EnemyKill(Enemies *enemies, int index);
+void EnemyFlush(Enemies *enemies);
+void OrbMerge(float cellSize);
+void OrbMergeDown(int target);
+void OrbCollision(Orb *orbs);
+void EnemyCollision(Enemies *enemies);
+void EnemySeparation(Enemies *enemies);
+void ProjectileHoming(Enemies *enemies);
+void ProjectileCollision(Enemies *enemies);
+void PlayerTakeDamage(int damage, Enemies *enemies);
+void EnemyTakeDamage(Enemies *enemies, int index, int damage);
+void PushEnemiesAway(Enemies *enemies);
+void enemiesSpawn(Enemies *enemies);
+void UpdateProjectiles(Projectile *projectiles);
+void enemyTrigger(Enemies *enemies, Vector2 position);
+void ally(Enemies *enemies);
+void setskillStatus(int skillIndex, bool status);
+bool getskillStatus(int skillIndex);
+void ResetGameState();
+
+#endif
@@ -0,0 +1,483 @@
+// Benchmark de la simulacion: ejecuta escenarios fijos sin ventana y mide
+// ns/tick por subsistema con las zonas del profiler.
+//
+//   bench [-o salida.json] [-b baseline.json] [-t umbral%] [-r pasadas] [-j hilos] [-s 0|1] escenario.txt...
+//
+// El resultado sale en JSON por stdout (o en -o). Cada escenario se ejecuta
+// -r veces (5 por defecto) y de cada zona se queda el minimo: una pasada
+// suelta varia mas que el umbral (el sistema, la frecuencia de la CPU) y el
+// minimo es lo que de verdad cuesta. Con -b se compara cada zona contra un
+// resultado anterior guardado y el programa devuelve 1 si el SimStep de
+// algun escenario empeora mas que el umbral (15% por defecto).
+// -s 0 apaga la separacion entre enemigos en todos los escenarios (-s 1 la
+// enciende): con -b se compara el coste contra una pasada con la otra opcion.
+//
+// Formato de escenario (scenarios/*.txt), una clave por linea:
+//   name = horda          ticks = 6000       warmup = 120     seed = 1234
+//   dt = 0.016667         time = 60          enemies = 400    orbs = 100
+//   fill = 0.3            shoot = 1          skills = tormenta, almas, sierra
+//   mode = horde          (normal por defecto; horde sube los limites)
+//   separation = 0        (1 por defecto)
+//   budget_ms = 8         (SimStep maximo por tick; sin clave no hay limite)
+//
+// 'time' fija totalGameTime en cada tick (y con el el ritmo de aparicion),
+// 'enemies' y 'orbs' se rellenan cada tick hasta esa cantidad repartidos en
+// la fraccion 'fill' de la arena, y el jugador no puede morir: la carga es la
+// misma de principio a fin y no depende de lo que pase en la partida. Si el
+// SimStep de un escenario pasa de su 'budget_ms' el programa devuelve 1,
+// haya baseline o no. El tiempo depende de la maquina y de los hilos (-j):
+// el escenario anota con cuales se fijo y deja margen para el ruido.
+//
+// Al final de cada escenario se guarda y se restaura una instantanea del
+// estado (SimSnapshotSave/Restore) y se anotan su tamano y lo que tarda.
+#ifndef PROFILER
+    #define PROFILER    // Las zonas son la medida: siempre activas aqui
+#endif
+#include "sim.h"
+#include "profiler.h"
+#include "jobs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define MAX_SCENARIOS 32
+#define MAX_BASELINE 1024
+#define SNAPSHOT_REPEATS 16
+#define DEFAULT_RUNS 5
+
+typedef struct Scenario {
+    char name[64];
+    unsigned int seed;
+    long ticks;
+    long warmup;
+    float dt;
+    float gameTime;
+    int enemies;
+    int orbs;
+    float fill;
+    bool shoot;
+    SimMode mode;
+    bool separation;
+    float budgetMs;             // 0: sin presupuesto
+    bool skills[SKILLS_COUNT];
+} Scenario;
+
+typedef struct ScenarioResult {
+    int runs;
+    long ticks;
+    int maxEnemies;
+    size_t arenaBytes;
+    size_t snapshotBytes;
+    double snapshotSaveNs;
+    double snapshotRestoreNs;
+    double nsPerTick[PROFILE_ZONE_COUNT];
+} ScenarioResult;
+
+typedef struct BaselineEntry {
+    char scenario[64];
+    char key[64];
+    double value;
+} BaselineEntry;
+
+// Mismo orden que setskillStatus()
+static const char *skillKeys[SKILLS_COUNT] = {
+    "resurrect", "disparo_mejorado", "movimiento_agil", "regeneracion",
+    "bifurcacion", "aliado", "tormenta", "furia", "explosion", "iman",
+    "disparo_rapido", "almas", "sierra", "corazon"
+};
+
+static BaselineEntry baseline[MAX_BASELINE];
+static int baselineCount = 0;
+
+//----------------------------------------------------------------------------------
+// Escenarios
+//----------------------------------------------------------------------------------
+static char *Trim(char *text)
+{
+    while (isspace((unsigned char)*text)) text++;
+    char *end = text + strlen(text);
+    while (end > text && isspace((unsigned char)end[-1])) *--end = '\0';
+    return text;
+}
+
+static bool LoadScenario(const char *fileName, Scenario *scenario)
+{
+    FILE *file = fopen(fileName, "r");
+    if (file == NULL) {
+        fprintf(stderr, "bench: no se pudo abrir %s\n", fileName);
+        return false;
+    }
+
+    *scenario = (Scenario){ 0 };
+    scenario->seed = 1234u;
+    scenario->ticks = 6000;
+    scenario->warmup = 120;
+    scenario->dt = 1.0f/60.0f;
+    scenario->fill = 0.25f;
+    scenario->shoot = true;
+    scenario->separation = true;
+
+    // Nombre por defecto: el archivo sin ruta ni extension
+    const char *base = strrchr(fileName, '/');
+    base = (base != NULL)? base + 1 : fileName;
+    snprintf(scenario->name, sizeof(scenario->name), "%s", base);
+    char *dot = strrchr(scenario->name, '.');
+    if (dot != NULL) *dot = '\0';
+
+    char line[256];
+    int lineNumber = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        lineNumber++;
+        char *comment = strchr(line, '#');
+        if (comment != NULL) *comment = '\0';
+        char *equals = strchr(line, '=');
+        if (equals == NULL) continue;
+        *equals = '\0';
+        char *key = Trim(line);
+        char *value = Trim(equals + 1);
+
+        if (strcmp(key, "name") == 0) snprintf(scenario->name, sizeof(scenario->name), "%s", value);
+        else if (strcmp(key, "seed") == 0) scenario->seed = (unsigned int)strtoul(value, NULL, 10);
+        else if (strcmp(key, "ticks") == 0) scenario->ticks = atol(value);
+        else if (strcmp(key, "warmup") == 0) scenario->warmup = atol(value);
+        else if (strcmp(key, "dt") == 0) scenario->dt = (float)atof(value);
+        else if (strcmp(key, "time") == 0) scenario->gameTime = (float)atof(value);
+        else if (strcmp(key, "enemies") == 0) scenario->enemies = atoi(value);
+        else if (strcmp(key, "orbs") == 0) scenario->orbs = atoi(value);
+        else if (strcmp(key, "fill") == 0) scenario->fill = (float)atof(value);
+        else if (strcmp(key, "shoot") == 0) scenario->shoot = (atoi(value) != 0);
+        else if (strcmp(key, "separation") == 0) scenario->separation = (atoi(value) != 0);
+        else if (strcmp(key, "budget_ms") == 0) scenario->budgetMs = (float)atof(value);
+        else if (strcmp(key, "mode") == 0) {
+            if (strcmp(value, "horde") == 0) scenario->mode = SIM_MODE_HORDE;
+            else if (strcmp(value, "normal") == 0) scenario->mode = SIM_MODE_NORMAL;
+            else fprintf(stderr, "bench: %s:%d: modo desconocido '%s'\n", fileName, lineNumber, value);
+        }
+        else if (strcmp(key, "skills") == 0) {
+            for (char *skill = strtok(value, ", \t"); skill != NULL; skill = strtok(NULL, ", \t")) {
+                int found = -1;
+                for (int s = 0; s < SKILLS_COUNT; s++) if (strcmp(skill, skillKeys[s]) == 0) found = s;
+                if (found < 0) fprintf(stderr, "bench: %s:%d: habilidad desconocida '%s'\n", fileName, lineNumber, skill);
+                else scenario->skills[found] = true;
+            }
+        }
+        else fprintf(stderr, "bench: %s:%d: clave desconocida '%s'\n", fileName, lineNumber, key);
+    }
+    fclose(file);
+
+    bool horde = (scenario->mode == SIM_MODE_HORDE);
+    int enemyLimit = horde? HORDE_MAX_ENEMIES : MAX_ENEMIES;
+    int orbLimit = horde? HORDE_MAX_ORBS : MAX_ORBS;
+    if (scenario->enemies > enemyLimit) scenario->enemies = enemyLimit;
+    if (scenario->orbs > orbLimit) scenario->orbs = orbLimit;
+    return true;
+}
+
+// Punto al azar dentro de la fraccion 'fill' de la arena
+static Vector2 ScenarioPosition(const Scenario *scenario)
+{
+    int extent = (int)(2500.0f*scenario->fill);
+    return (Vector2){ (float)SimRandomValue(-extent, extent), (float)SimRandomValue(-extent, extent) };
+}
+
+static void ApplySkills(const Scenario *scenario)
+{
+    for (int s = 0; s < SKILLS_COUNT; s++) setskillStatus(s, scenario->skills[s]);
+}
+
+// Deja el estado listo para el siguiente tick: sin menus, sin muerte ni
+// victoria y con la poblacion del escenario
+static void PrepareTick(const Scenario *scenario)
+{
+    if (sim.deathScreen || sim.winScreen) {
+        ResetGameState();
+        ApplySkills(scenario);
+    }
+    sim.upgradeMenu = false;
+    sim.deathScreen = false;
+    sim.winScreen = false;
+    sim.menuActive = false;
+
+    sim.totalGameTime = scenario->gameTime;
+    sim.player.health = sim.player.maxHealth;
+
+    while (enemies.count < scenario->enemies) GenEnemies(ScenarioPosition(scenario), 1);
+    while (orbPool.count < scenario->orbs) GenOrbs(ScenarioPosition(scenario), 1);
+}
+
+static SimInput ScenarioInput(const Scenario *scenario, long tick)
+{
+    SimInput input = { 0 };
+    int phase = (int)((tick/60)%4);
+
+    input.up = (phase == 0);
+    input.right = (phase == 1);
+    input.down = (phase == 2);
+    input.left = (phase == 3);
+    input.shoot = scenario->shoot;
+    input.aim.x = sim.player.position.x + 100.0f*(float)((tick%120) - 60);
+    input.aim.y = sim.player.position.y + 100.0f*(float)(((tick + 60)%120) - 60);
+    return input;
+}
+
+// Media de varias vueltas; la restauracion tiene que dejar el mismo estado
+static void MeasureSnapshot(ScenarioResult *result)
+{
+    size_t size = SimSnapshotSize();
+    void *snapshot = malloc(size);
+    if (snapshot == NULL) return;
+    unsigned int checksum = SimChecksum();
+
+    unsigned long long start = ProfilerNow();
+    for (int r = 0; r < SNAPSHOT_REPEATS; r++) SimSnapshotSave(snapshot, size);
+    unsigned long long saved = ProfilerNow();
+    for (int r = 0; r < SNAPSHOT_REPEATS; r++) SimSnapshotRestore(snapshot, size);
+    unsigned long long restored = ProfilerNow();
+
+    if (SimChecksum() != checksum) fprintf(stderr, "bench: la instantanea no restaura el mismo estado\n");
+    result->snapshotBytes = size;
+    result->snapshotSaveNs = (double)(saved - start)/SNAPSHOT_REPEATS;
+    result->snapshotRestoreNs = (double)(restored - saved)/SNAPSHOT_REPEATS;
+    free(snapshot);
+}
+
+static ScenarioResult RunScenario(const Scenario *scenario)
+{
+    ScenarioResult result = { 0 };
+
+    SimSetMode(scenario->mode);
+    crowdSeparation = scenario->separation;
+    SimInit(scenario->seed);
+    ApplySkills(scenario);
+
+    for (long tick = 0; tick < scenario->warmup + scenario->ticks; tick++) {
+        if (tick == scenario->warmup) ProfilerReset();
+
+        PrepareTick(scenario);
+        SimInput input = ScenarioInput(scenario, tick);
+        PROFILE_ZONE(PROFILE_SIM_STEP) SimStep(&input, scenario->dt);
+        PROFILE_FRAME_END();
+
+        if (enemies.count > result.maxEnemies) result.maxEnemies = enemies.count;
+    }
+    result.arenaBytes = SimMemoryUsed();
+    MeasureSnapshot(&result);
+
+    result.ticks = ProfilerFrameCount();
+    for (int z = 0; z < PROFILE_ZONE_COUNT; z++) {
+        result.nsPerTick[z] = (result.ticks > 0)? (double)ProfilerZoneTotalNs(z)/result.ticks : 0.0;
+    }
+    return result;
+}
+
+// Minimo de cada medida entre varias pasadas del mismo escenario
+static ScenarioResult RunScenarioBest(const Scenario *scenario, int runs)
+{
+    ScenarioResult best = RunScenario(scenario);
+    for (int r = 1; r < runs; r++) {
+        ScenarioResult result = RunScenario(scenario);
+        for (int z = 0; z < PROFILE_ZONE_COUNT; z++) {
+            if (result.nsPerTick[z] < best.nsPerTick[z]) best.nsPerTick[z] = result.nsPerTick[z];
+        }
+        if (result.snapshotSaveNs < best.snapshotSaveNs) best.snapshotSaveNs = result.snapshotSaveNs;
+        if (result.snapshotRestoreNs < best.snapshotRestoreNs) best.snapshotRestoreNs = result.snapshotRestoreNs;
+    }
+    best.runs = runs;
+    return best;
+}
+
+//----------------------------------------------------------------------------------
+// JSON
+//----------------------------------------------------------------------------------
+static void WriteResults(FILE *out, const Scenario *scenarios, const ScenarioResult *results, int count)
+{
+    fprintf(out, "{\n  \"scenarios\": [\n");
+    for (int i = 0; i < count; i++) {
+        fprintf(out, "    {\n");
+        fprintf(out, "      \"name\": \"%s\",\n", scenarios[i].name);
+        fprintf(out, "      \"seed\": %u,\n", scenarios[i].seed);
+        fprintf(out, "      \"threads\": %d,\n", JobThreadCount());
+        fprintf(out, "      \"separation\": %s,\n", scenarios[i].separation? "true" : "false");
+        fprintf(out, "      \"math\": \"%s\",\n", SimMathName());
+        if (scenarios[i].budgetMs > 0.0f) fprintf(out, "      \"budget_ms\": %.2f,\n", scenarios[i].budgetMs);
+        fprintf(out, "      \"runs\": %d,\n", results[i].runs);
+        fprintf(out, "      \"ticks\": %ld,\n", results[i].ticks);
+        fprintf(out, "      \"max_enemies\": %d,\n", results[i].maxEnemies);
+        fprintf(out, "      \"arena_bytes\": %zu,\n", results[i].arenaBytes);
+        fprintf(out, "      \"snapshot_bytes\": %zu,\n", results[i].snapshotBytes);
+        fprintf(out, "      \"snapshot_save_ns\": %.1f,\n", results[i].snapshotSaveNs);
+        fprintf(out, "      \"snapshot_restore_ns\": %.1f,\n", results[i].snapshotRestoreNs);
+        fprintf(out, "      \"ns_per_tick\": {\n");
+        bool first = true;
+        for (int z = 0; z < PROFILE_ZONE_COUNT; z++) {
+            if (results[i].nsPerTick[z] <= 0.0) continue;
+            fprintf(out, "%s        \"%s\": %.1f", first? "" : ",\n", ProfilerZoneName(z), results[i].nsPerTick[z]);
+            first = false;
+        }
+        fprintf(out, "\n      }\n    }%s\n", (i < count - 1)? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+// Lector minimo para el JSON que escribe WriteResults: guarda cada par
+// "clave": numero bajo el ultimo "name" visto
+static bool LoadBaseline(const char *fileName)
+{
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "bench: no se pudo abrir la baseline %s\n", fileName);
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *text = malloc(size + 1);
+    size = (long)fread(text, 1, size, file);
+    text[size] = '\0';
+    fclose(file);
+
+    char scenario[64] = "";
+    char *p = text;
+    while ((p = strchr(p, '"')) != NULL) {
+        char *keyEnd = strchr(p + 1, '"');
+        if (keyEnd == NULL) break;
+        char key[64];
+        snprintf(key, sizeof(key), "%.*s", (int)(keyEnd - p - 1), p + 1);
+        p = keyEnd + 1;
+        while (isspace((unsigned char)*p)) p++;
+        if (*p != ':') continue;
+        p++;
+        while (isspace((unsigned char)*p)) p++;
+
+        if (*p == '"') {
+            char *valueEnd = strchr(p + 1, '"');
+            if (valueEnd == NULL) break;
+            if (strcmp(key, "name") == 0) snprintf(scenario, sizeof(scenario), "%.*s", (int)(valueEnd - p - 1), p + 1);
+            p = valueEnd + 1;
+        } else if (isdigit((unsigned char)*p) || *p == '-') {
+            char *numberEnd;
+            double value = strtod(p, &numberEnd);
+            if (baselineCount < MAX_BASELINE) {
+                BaselineEntry *entry = &baseline[baselineCount++];
+                snprintf(entry->scenario, sizeof(entry->scenario), "%s", scenario);
+                snprintf(entry->key, sizeof(entry->key), "%s", key);
+                entry->value = value;
+            }
+            p = numberEnd;
+        }
+    }
+    free(text);
+    return true;
+}
+
+static bool FindBaseline(const char *scenario, const char *key, double *value)
+{
+    for (int i = 0; i < baselineCount; i++) {
+        if (strcmp(baseline[i].scenario, scenario) == 0 && strcmp(baseline[i].key, key) == 0) {
+            *value = baseline[i].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Tabla por stderr; devuelve true si algun SimStep supera el umbral
+static bool CompareBaseline(const Scenario *scenarios, const ScenarioResult *results, int count, double threshold)
+{
+    bool regressed = false;
+    for (int i = 0; i < count; i++) {
+        fprintf(stderr, "\n%s\n%-24s %12s %12s %9s\n", scenarios[i].name, "zona", "base ns", "ns", "cambio");
+        for (int z = 0; z < PROFILE_ZONE_COUNT; z++) {
+            double before = 0.0;
+            bool known = FindBaseline(scenarios[i].name, ProfilerZoneName(z), &before);
+            if (!known && results[i].nsPerTick[z] <= 0.0) continue;
+
+            double after = results[i].nsPerTick[z];
+            if (!known || before <= 0.0) {
+                fprintf(stderr, "%-24s %12s %12.1f %9s\n", ProfilerZoneName(z), "-", after, "nuevo");
+                continue;
+            }
+            double change = (after - before)*100.0/before;
+            bool bad = (z == PROFILE_SIM_STEP && change > threshold);
+            fprintf(stderr, "%-24s %12.1f %12.1f %+8.1f%%%s\n", ProfilerZoneName(z), before, after, change, bad? "  <-- REGRESION" : "");
+            if (bad) regressed = true;
+        }
+    }
+    return regressed;
+}
+
+// Escenarios cuyo SimStep pasa de su presupuesto; devuelve true si alguno
+static bool CheckBudgets(const Scenario *scenarios, const ScenarioResult *results, int count)
+{
+    bool over = false;
+    for (int i = 0; i < count; i++) {
+        if (scenarios[i].budgetMs <= 0.0f) continue;
+        double ms = results[i].nsPerTick[PROFILE_SIM_STEP]/1e6;
+        bool bad = (ms > scenarios[i].budgetMs);
+        fprintf(stderr, "bench: %s: SimStep %.2f ms, presupuesto %.2f ms%s\n", scenarios[i].name, ms, scenarios[i].budgetMs, bad? "  <-- SOBRE PRESUPUESTO" : "");
+        if (bad) over = true;
+    }
+    return over;
+}
+
+//----------------------------------------------------------------------------------
+// Main
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    static Scenario scenarios[MAX_SCENARIOS];
+    static ScenarioResult results[MAX_SCENARIOS];
+    int scenarioCount = 0;
+    const char *outputName = NULL;
+    const char *baselineName = NULL;
+    double threshold = 15.0;
+    int threads = 0;
+    int separation = -1;        // -1: lo que diga cada escenario
+    int runs = DEFAULT_RUNS;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) outputName = argv[++i];
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) baselineName = argv[++i];
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) threshold = atof(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) runs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) separation = (atoi(argv[++i]) != 0);
+        else if (scenarioCount < MAX_SCENARIOS) {
+            if (!LoadScenario(argv[i], &scenarios[scenarioCount])) return 2;
+            scenarioCount++;
+        }
+    }
+    if (scenarioCount == 0) {
+        fprintf(stderr, "uso: bench [-o salida.json] [-b baseline.json] [-t umbral%%] [-r pasadas] [-j hilos] [-s 0|1] escenario.txt...\n");
+        return 2;
+    }
+    if (runs < 1) runs = 1;
+    if (baselineName != NULL && !LoadBaseline(baselineName)) return 2;
+    if (separation >= 0) {
+        for (int i = 0; i < scenarioCount; i++) scenarios[i].separation = (separation != 0);
+    }
+
+    // -j 1: todo en el hilo principal; sin -j: un hilo por nucleo
+    if (threads != 1) JobSystemInit(threads - 1);
+
+    for (int i = 0; i < scenarioCount; i++) {
+        fprintf(stderr, "bench: %s (%ld ticks x %d)\n", scenarios[i].name, scenarios[i].ticks, runs);
+        results[i] = RunScenarioBest(&scenarios[i], runs);
+    }
+
+    FILE *out = stdout;
+    if (outputName != NULL) {
+        out = fopen(outputName, "w");
+        if (out == NULL) {
+            fprintf(stderr, "bench: no se pudo escribir %s\n", outputName);
+            return 2;
+        }
+    }
+    WriteResults(out, scenarios, results, scenarioCount);
+    if (out != stdout) fclose(out);
+
+    bool failed = CheckBudgets(scenarios, results, scenarioCount);
+    if (baselineName != NULL && CompareBaseline(scenarios, results, scenarioCount, threshold)) failed = true;
+    return failed? 1 : 0;
+}
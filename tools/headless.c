@@ -0,0 +1,160 @@
+// Simulacion sin ventana ni contexto GL: soak tests y ticks por segundo en
+// maquinas sin GPU ni pantalla.
+//
+//   headless [--horde] [ticks] [seed] [dt]
+//   headless [--horde] --record partida.rpl [ticks] [seed] [dt]
+//   headless --replay partida.rpl
+//
+// Un bot sencillo mueve al jugador en circulo, dispara sin parar, elige
+// mejoras y reinicia la partida al morir o ganar. Con --record la partida
+// del bot se graba; con --replay se repite una grabacion (del bot o del
+// juego) comprobando el checksum de cada tick.
+#include "sim.h"
+#include "profiler.h"
+#include "replay.h"
+#include "jobs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+static double NowSeconds(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart/(double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec*1e-9;
+#endif
+}
+
+// Entrada del bot para el tick indicado
+static SimInput BotInput(long tick)
+{
+    SimInput input = { 0 };
+    int phase = (int)((tick/60)%4);
+
+    input.up = (phase == 0);
+    input.right = (phase == 1);
+    input.down = (phase == 2);
+    input.left = (phase == 3);
+    input.shoot = true;
+
+    // Menus: todo pasa por la entrada para que la grabacion sea completa.
+    // Nada de SimRandomValue aqui: gastaria numeros fuera de SimStep
+    if (sim.upgradeMenu) {
+        int offered = 0;
+        while (offered < 3 && sim.upgradeOffer[offered] >= 0) offered++;
+        if (offered > 0) input.upgradeChoice = 1 + (int)(tick%offered);
+        else input.closeMenu = true;
+    }
+    input.restart = sim.deathScreen || sim.winScreen;
+
+    // Apunta girando alrededor del jugador
+    input.aim.x = sim.player.position.x + 100.0f*(float)((tick%120) - 60);
+    input.aim.y = sim.player.position.y + 100.0f*(float)(((tick + 60)%120) - 60);
+    return input;
+}
+
+static int Replay(const char *fileName)
+{
+    ReplayResult result;
+    double start = NowSeconds();
+    if (!ReplayRun(fileName, &result)) {
+        fprintf(stderr, "headless: no se pudo leer la grabacion %s\n", fileName);
+        return 2;
+    }
+    double elapsed = NowSeconds() - start;
+
+    printf("replay: %s\n", fileName);
+    printf("ticks: %ld\n", result.ticks);
+    printf("elapsed: %.3f s\n", elapsed);
+    printf("ticks/s: %.0f\n", (elapsed > 0.0)? (double)result.ticks/elapsed : 0.0);
+    if (result.desyncTick >= 0) {
+        printf("DESYNC en el tick %ld (esperado %08x, obtenido %08x)\n", result.desyncTick, result.expected, result.actual);
+        return 1;
+    }
+    printf("checksums: ok\n");
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *recordName = NULL;
+    JobSystemInit(0);
+    if (argc > 2 && strcmp(argv[1], "--replay") == 0) return Replay(argv[2]);
+    if (argc > 1 && strcmp(argv[1], "--horde") == 0) {
+        SimSetMode(SIM_MODE_HORDE);
+        argc -= 1;
+        argv += 1;
+    }
+    if (argc > 2 && strcmp(argv[1], "--record") == 0) {
+        recordName = argv[2];
+        argc -= 2;
+        argv += 2;
+    }
+
+    long ticks = (argc > 1) ? atol(argv[1]) : 36000;
+    unsigned int seed = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 10) : 1234u;
+    float dt = (argc > 3) ? (float)atof(argv[3]) : 1.0f/60.0f;
+
+    SimInit(seed);
+    if (recordName != NULL && !ReplayRecordBegin(recordName, seed)) {
+        fprintf(stderr, "headless: no se pudo crear %s\n", recordName);
+        return 2;
+    }
+
+    int runs = 1;
+    int totalKills = 0;
+    int peakEnemies = 0;
+    double start = NowSeconds();
+
+    for (long tick = 0; tick < ticks; tick++) {
+        SimInput input = BotInput(tick);
+        if (input.restart) {
+            totalKills += sim.enemiesKilled;
+            runs++;
+        }
+        PROFILE_ZONE(PROFILE_SIM_STEP) SimStep(&input, dt);
+        PROFILE_FRAME_END();
+        if (recordName != NULL) ReplayRecordTick(&input, dt, SimChecksum());
+
+        if (enemies.count > peakEnemies) peakEnemies = enemies.count;
+    }
+    ReplayRecordEnd();
+
+    double elapsed = NowSeconds() - start;
+    totalKills += sim.enemiesKilled;
+
+    printf("ticks: %ld\n", ticks);
+    printf("seed: %u\n", seed);
+    printf("threads: %d\n", JobThreadCount());
+    printf("math: %s\n", SimMathName());
+    printf("elapsed: %.3f s\n", elapsed);
+    printf("ticks/s: %.0f\n", (elapsed > 0.0)? (double)ticks/elapsed : 0.0);
+    printf("runs: %d\n", runs);
+    printf("kills: %d\n", totalKills);
+    printf("max enemies: %d\n", peakEnemies);
+    printf("arena: %.1f KB\n", SimMemoryUsed()/1024.0);
+
+#if defined(PROFILER)
+    printf("\nzona (ultimos %d ticks)   media ms   max ms\n", PROFILER_HISTORY);
+    for (int z = 0; z < PROFILE_ZONE_COUNT; z++) {
+        ProfileZoneStats stats = ProfilerGetZoneStats(z);
+        if (stats.samples == 0) continue;
+        printf("%-24s %9.4f %8.4f\n", ProfilerZoneName(z), stats.averageMs, stats.maxMs);
+    }
+    ProfilerDumpTrace("profile_trace.json");
+#endif
+
+    return 0;
+}
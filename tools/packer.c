@@ -0,0 +1,184 @@
+// Empaqueta texturas y sonidos ya decodificados en un archivo de recursos
+// (formato en archive.h) que el juego mapea en memoria al arrancar.
+//
+//   packer assets.pak textures sound/shoot.ogg
+//
+// Cada argumento es un archivo o una carpeta (se recorre entera buscando
+// .png, .jpg, .ogg y .wav). Los nombres se guardan tal cual se pasan, con
+// '/': se ejecuta desde la carpeta del juego para que coincidan con las
+// rutas que pide. Al final dice cuanto tardo en decodificar todo, que es lo
+// que se ahorra el juego al arrancar con el archivo.
+#include "raylib.h"
+#include "archive.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI
+    #define NOUSER
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+#define PACKER_EXTENSIONS ".png;.jpg;.ogg;.wav"
+
+typedef struct PackerName {
+    char name[ARCHIVE_NAME_LENGTH];
+} PackerName;
+
+static PackerName *names = NULL;
+static int nameCount = 0;
+static int nameCapacity = 0;
+
+static void AddName(const char *path)
+{
+    if (strlen(path) >= ARCHIVE_NAME_LENGTH) {
+        fprintf(stderr, "packer: ruta demasiado larga, se omite: %s\n", path);
+        return;
+    }
+    if (nameCount == nameCapacity) {
+        nameCapacity = (nameCapacity == 0)? 64 : nameCapacity*2;
+        names = realloc(names, nameCapacity*sizeof(PackerName));
+    }
+    memset(&names[nameCount], 0, sizeof(PackerName));
+    strcpy(names[nameCount].name, path);
+    // En Windows las carpetas se recorren con '\'
+    for (char *c = names[nameCount].name; *c != '\0'; c++) if (*c == '\\') *c = '/';
+    nameCount++;
+}
+
+// GetTime() necesita la ventana
+static double NowSeconds(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart/(double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec*1e-9;
+#endif
+}
+
+static int CompareNames(const void *a, const void *b)
+{
+    return strcmp(((const PackerName *)a)->name, ((const PackerName *)b)->name);
+}
+
+static bool IsWaveFile(const char *name)
+{
+    return IsFileExtension(name, ".ogg;.wav");
+}
+
+// Rellena con ceros hasta la siguiente posicion alineada
+static unsigned int Align(FILE *file, unsigned int offset)
+{
+    static const unsigned char zeros[ARCHIVE_ALIGNMENT] = { 0 };
+    unsigned int padding = (ARCHIVE_ALIGNMENT - offset%ARCHIVE_ALIGNMENT)%ARCHIVE_ALIGNMENT;
+    fwrite(zeros, 1, padding, file);
+    return offset + padding;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        fprintf(stderr, "uso: packer salida.pak carpeta|archivo...\n");
+        return 1;
+    }
+    SetTraceLogLevel(LOG_WARNING);
+
+    for (int i = 2; i < argc; i++) {
+        if (DirectoryExists(argv[i])) {
+            FilePathList files = LoadDirectoryFilesEx(argv[i], PACKER_EXTENSIONS, true);
+            for (unsigned int f = 0; f < files.count; f++) AddName(files.paths[f]);
+            UnloadDirectoryFiles(files);
+        } else if (FileExists(argv[i])) {
+            AddName(argv[i]);
+        } else {
+            fprintf(stderr, "packer: no existe %s\n", argv[i]);
+        }
+    }
+    // El juego busca por nombre con bsearch
+    qsort(names, nameCount, sizeof(PackerName), CompareNames);
+
+    FILE *file = fopen(argv[1], "wb");
+    if (file == NULL) {
+        fprintf(stderr, "packer: no se puede escribir %s\n", argv[1]);
+        return 1;
+    }
+    ArchiveHeader header = { 0 };
+    memcpy(header.magic, "APAK", 4);
+    header.version = ARCHIVE_VERSION;
+    fwrite(&header, sizeof(header), 1, file);
+
+    ArchiveEntry *entries = calloc(nameCount > 0? nameCount : 1, sizeof(ArchiveEntry));
+    unsigned int offset = sizeof(header);
+    double decodeTime = 0.0;
+    int count = 0;
+
+    for (int i = 0; i < nameCount; i++) {
+        if (i > 0 && strcmp(names[i - 1].name, names[i].name) == 0) continue;
+
+        ArchiveEntry *entry = &entries[count];
+        const void *data = NULL;
+        Image image = { 0 };
+        Wave wave = { 0 };
+        double start = NowSeconds();
+        if (IsWaveFile(names[i].name)) {
+            wave = LoadWave(names[i].name);
+            data = wave.data;
+            entry->kind = ARCHIVE_WAVE;
+            entry->frameCount = wave.frameCount;
+            entry->sampleRate = wave.sampleRate;
+            entry->sampleSize = wave.sampleSize;
+            entry->channels = wave.channels;
+            entry->size = wave.frameCount*wave.channels*(wave.sampleSize/8);
+        } else {
+            image = LoadImage(names[i].name);
+            data = image.data;
+            entry->kind = ARCHIVE_IMAGE;
+            entry->width = image.width;
+            entry->height = image.height;
+            entry->format = image.format;
+            entry->mipmaps = 1;
+            entry->size = (unsigned int)GetPixelDataSize(image.width, image.height, image.format);
+        }
+        decodeTime += NowSeconds() - start;
+
+        if (data == NULL) {
+            fprintf(stderr, "packer: no se pudo decodificar %s\n", names[i].name);
+            memset(entry, 0, sizeof(*entry));
+            continue;
+        }
+        strcpy(entry->name, names[i].name);
+        offset = Align(file, offset);
+        entry->offset = offset;
+        fwrite(data, 1, entry->size, file);
+        offset += entry->size;
+        count++;
+
+        if (entry->kind == ARCHIVE_WAVE) UnloadWave(wave);
+        else UnloadImage(image);
+    }
+
+    // Indice al final y la cabecera se reescribe con su posicion
+    offset = Align(file, offset);
+    header.entryCount = (unsigned int)count;
+    header.indexOffset = offset;
+    fwrite(entries, sizeof(ArchiveEntry), count, file);
+    offset += count*sizeof(ArchiveEntry);
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, file);
+    fclose(file);
+
+    printf("%s: %d recursos, %.1f MB (decodificar: %.1f ms)\n",
+           argv[1], count, offset/(1024.0*1024.0), decodeTime*1000.0);
+    free(entries);
+    free(names);
+    return 0;
+}